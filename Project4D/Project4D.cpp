@@ -1,12 +1,249 @@
 ﻿#include "src/renderer.h"
+#include "src/exporter.h"
+#include "src/frameScheduler.h"
+#include "src/profiler.h"
+#include "src/allocationCounter.h"
+#include "src/polytope.h"
 #include <thread>
 #include <chrono>
+#include <string>
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+
+// Разбор числа из аргумента целиком; false, если в строке не только число
+template <typename T>
+bool ParseArgument(const char* text, T& value) {
+    const char* end = text + std::strlen(text);
+    auto result = std::from_chars(text, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// Пакетная выгрузка срезов без окна: Project4D --export <папка> <wНачало> <wКонец> <количество> [ply|obj]
+int ExportSlices(int argc, char** argv) {
+    float wBegin = 0.0f, wEnd = 0.0f;
+    int count = 0;
+    if (argc < 6 || !ParseArgument(argv[3], wBegin) || !ParseArgument(argv[4], wEnd) || !ParseArgument(argv[5], count) || count < 1) {
+        std::cerr << "Использование: Project4D --export <папка> <wНачало> <wКонец> <количество ≥ 1> [ply|obj]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ExportFormat format = (argc > 6 && std::string(argv[6]) == "obj") ? ExportFormat::OBJ : ExportFormat::PLY;
+    Model4D tesseract(Model4DType::Tesseract, glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
+
+    SliceExporter exporter(format);
+    int written = exporter.ExportSweep(tesseract, wBegin, wEnd, count, argv[2]);
+    std::cout << "Записано срезов: " << written << std::endl;
+
+    return written == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Проверка среза без выделений кучи в установившемся режиме: Project4D --alloc-check [кадров]
+int CheckAllocations(int argc, char** argv) {
+    if (!AllocationCounter::IsEnabled()) {
+        std::cerr << "Счётчик выделений недоступен: сборка без PROJECT4D_ALLOCATION_COUNTER" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int frames = 1000;
+    if (argc > 2 && (!ParseArgument(argv[2], frames) || frames < 1)) {
+        std::cerr << "Использование: Project4D --alloc-check [кадров ≥ 1]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    Model4D tesseract(Model4DType::Tesseract, glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
+    PolytopeModel4D<Cell24> cell24(glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
+
+    // Кадр как в основном цикле, плюс полный пересчёт среза, чтобы не проверять только инкрементальный путь
+    auto frame = [&]() {
+        tesseract.StepRotate4D(0.1f, 0.1f, 0.1f, 1.0f / 120.0f);
+        tesseract.Interpolate(0.5f);
+        tesseract.GenerateSlice(tesseract.GetWSlice());
+        cell24.SetTransform4D(tesseract.GetTransform4D(), tesseract.GetOffset4D());
+        cell24.GenerateSlice(cell24.GetWSlice());
+    };
+
+    // Прогрева нет: модели при загрузке выделяют место под худший срез, счёт идёт с первого кадра
+    AllocationScope scope;
+    for (int i = 0; i < frames; ++i) {
+        frame();
+    }
+    size_t allocations = scope.GetCount();
+
+    std::cout << "Выделений за " << frames << " кадров: " << allocations << std::endl;
+    return allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Совпадение вершин двух срезов как множеств: у каждой вершины одного среза есть своя пара в другом
+static bool SameSliceVertices(const std::vector<GLfloat>& expected, const std::vector<GLfloat>& actual) {
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+    std::vector<bool> matched(actual.size() / 6, false);
+    for (size_t i = 0; i < expected.size(); i += 6) {
+        glm::vec3 p(expected[i], expected[i + 1], expected[i + 2]);
+        bool found = false;
+        for (size_t j = 0; j < matched.size() && !found; ++j) {
+            glm::vec3 q(actual[j * 6], actual[j * 6 + 1], actual[j * 6 + 2]);
+            found = !matched[j] && glm::all(glm::lessThan(glm::abs(p - q), glm::vec3(1e-5f)));
+            matched[j] = matched[j] || found;
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Замкнутая поверхность сферы: каждое ребро у двух треугольников и V - E + F = 2; пустой срез тоже допустим
+static bool IsClosedSlice(const Model& model) {
+    const std::vector<GLuint>& indices = model.GetIndices();
+    size_t vertexCount = model.GetVertices().size() / 6;
+    if (indices.empty()) {
+        return vertexCount == 0;
+    }
+
+    std::vector<uint64_t> sides;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        for (size_t k = 0; k < 3; ++k) {
+            uint64_t a = indices[t + k], b = indices[t + (k + 1) % 3];
+            sides.push_back(std::min(a, b) << 32 | std::max(a, b));
+        }
+    }
+    std::sort(sides.begin(), sides.end());
+
+    size_t edgeCount = 0;
+    for (size_t i = 0; i < sides.size(); i += 2, ++edgeCount) {
+        if (i + 1 >= sides.size() || sides[i] != sides[i + 1] || (i + 2 < sides.size() && sides[i + 2] == sides[i])) {
+            return false;
+        }
+    }
+    return vertexCount + indices.size() / 3 == edgeCount + 2;
+}
+
+// Срез по таблицам времени компиляции против Model4D: совпадение вершин тессеракта, замкнутость сечений обеих фигур
+// и время одного среза обоими способами: Project4D --polytope-check [поз]
+int CheckPolytopeSlice(int argc, char** argv) {
+    int poses = 1000;
+    if (argc > 2 && (!ParseArgument(argv[2], poses) || poses < 1)) {
+        std::cerr << "Использование: Project4D --polytope-check [поз ≥ 1]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Model4D tesseract(Model4DType::Tesseract, glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
+    PolytopeModel4D<Tesseract> staticTesseract(glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
+    PolytopeModel4D<Cell24> cell24(glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
+
+    int mismatches = 0;
+    for (int i = 0; i < poses; ++i) {
+        tesseract.Rotate4D(0.1f, 0.13f, 0.07f, 0.05f);
+        float wSlice = -0.9f + 1.8f * (i % 37) / 36.0f;
+        tesseract.GenerateSlice(wSlice);
+        staticTesseract.SetTransform4D(tesseract.GetTransform4D(), tesseract.GetOffset4D());
+        staticTesseract.GenerateSlice(wSlice);
+        cell24.SetTransform4D(tesseract.GetTransform4D(), tesseract.GetOffset4D());
+        cell24.GenerateSlice(wSlice);
+
+        bool same = SameSliceVertices(tesseract.GetSliceVertices(), staticTesseract.GetVertices());
+        if (!same || !IsClosedSlice(staticTesseract) || !IsClosedSlice(cell24)) {
+            ++mismatches;
+        }
+    }
+
+    // Время среза в одной позе; сдвиг w на доли ulp не даёт компилятору вынести срез из цикла
+    const int repeats = 100000;
+    float wSlice = tesseract.GetWSlice();
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        tesseract.GenerateSlice(wSlice + 1e-7f * (i & 7));
+        sink += tesseract.GetIndices().size() / 3;
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        staticTesseract.GenerateSlice(wSlice + 1e-7f * (i & 7));
+        sink += staticTesseract.GetIndices().size() / 3;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Поз с расхождением среза по таблицам: " << mismatches << " из " << poses << std::endl;
+    std::cout << "Срез тессеракта: Model4D " << std::chrono::duration<double, std::nano>(middle - start).count() / repeats
+              << " нс, Polytope " << std::chrono::duration<double, std::nano>(end - middle).count() / repeats
+              << " нс (треугольников " << sink << ")" << std::endl;
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Сравнение GPU-среза с CPU-срезом по позам основного цикла (например, под Mesa llvmpipe): Project4D --compute-check [поз]
+int CheckComputeSlice(int argc, char** argv) {
+    int poses = 200;
+    if (argc > 2 && (!ParseArgument(argv[2], poses) || poses < 1)) {
+        std::cerr << "Использование: Project4D --compute-check [поз ≥ 1]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Renderer renderer(800, 600, "Project4D");
+    renderer.FinishShaders();
+    GLuint edgeProgram = renderer.shaderPrograms["sliceEdges"];
+    GLuint cellProgram = renderer.shaderPrograms["sliceCells"];
+
+    Model4D tesseract(Model4DType::Tesseract, glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
+
+    int mismatches = 0;
+    for (int i = 0; i < poses; ++i) {
+        tesseract.Rotate4D(0.1f, 0.13f, 0.07f, 0.05f);
+        tesseract.SetWSlice(-0.9f + 1.8f * (i % 37) / 36.0f);
+        if (!tesseract.CompareComputeSlice(edgeProgram, cellProgram)) {
+            ++mismatches;
+        }
+    }
+
+    std::cout << "Поз с расхождением GPU- и CPU-среза: " << mismatches << " из " << poses << std::endl;
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--export") {
+        return ExportSlices(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--alloc-check") {
+        return CheckAllocations(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--polytope-check") {
+        return CheckPolytopeSlice(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--compute-check") {
+        return CheckComputeSlice(argc, argv);
+    }
+
+    // Трасса кадров для chrome://tracing или Perfetto: Project4D --trace <файл> [кадров].
+    // Аргументы проверяются до создания окна
+    bool trace = argc > 1 && std::string(argv[1]) == "--trace";
+    int traceFrames = 300;
+    if (trace) {
+#if PROJECT4D_PROFILE
+        if (argc < 3 || (argc > 3 && !ParseArgument(argv[3], traceFrames))) {
+            std::cerr << "Использование: Project4D --trace <файл> [кадров]" << std::endl;
+            return EXIT_FAILURE;
+        }
+#else
+        std::cerr << "Трасса недоступна: сборка без PROJECT4D_PROFILER" << std::endl;
+        return EXIT_FAILURE;
+#endif
+    }
 
-int main() {
     Renderer renderer(800, 600, "Project4D");
+    renderer.SetVSync(true);
+
+#if PROJECT4D_PROFILE
+    // Отсчёт трассы начинается после создания окна, чтобы оно не попало в первый кадр
+    if (trace && !Profiler::Instance().StartTrace(argv[2], traceFrames)) {
+        return EXIT_FAILURE;
+    }
+#endif
 
-    double deltaTime;
+    // Вращение идёт шагами по 1/120 с независимо от частоты кадров
+    FrameScheduler scheduler(1.0 / 120.0);
 
+    // Шейдеры, отправленные конструктором Renderer, драйвер компилирует, пока здесь загружаются модели
     Model* cube = new Model(ModelType::Cube, glm::vec3(1.0f, -0.5f, 1.0f), glm::vec3(10.0f, 0.02f, 10.0f), glm::vec3(1.0f, 1.0f, 0.0f));
     renderer.AddModel(cube);
 
@@ -14,29 +251,36 @@ int main() {
     // Добавление тессеракта
     Model4D* tesseract = new Model4D(Model4DType::Tesseract, glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(0.87f, 0.1f, 0.12f, 1.0f), 0.1f);
     renderer.AddModel(tesseract);
+    renderer.SetRaymarchTarget(tesseract, SDF4DShape::Tesseract);
     tesseract->GenerateSlice(tesseract->GetWSlice());
 
+    // Модели готовы — дожидаемся программ, которые ещё собираются, до первого кадра
+    renderer.FinishShaders();
+
 
     while (!renderer.ShouldClose()) {
-		renderer.Time();
-        renderer.Clear();
+        int steps = scheduler.BeginFrame();
+        renderer.PollEvents((float)scheduler.GetFrameTime());
 
-        
-        glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
-        
-        tesseract->InitBuffers();
+        // Симуляция: фиксированные шаги, затем одна интерполированная поза и один срез на кадр
+        for (int i = 0; i < steps; ++i) {
+            tesseract->StepRotate4D(0.1f, 0.1f, 0.1f, (float)scheduler.GetFixedStep());
+        }
+        tesseract->Interpolate(scheduler.GetAlpha());
+        PROFILE_COUNTER("slice vertices", tesseract->GetSliceVertices().size() / 6);
+        PROFILE_COUNTER("slice triangles", tesseract->GetIndices().size() / 3);
 
-        deltaTime = renderer.GetDeltaTime();
+        renderer.Clear();
+        glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
 
-        //tesseract->Rotate(0.1f, 0.1f, 0.1f, deltaTime);
-		tesseract->Rotate4D(0.1f, 0.1f, 0.1f, deltaTime);
+        tesseract->InitBuffers();
 
-        renderer.GetCamera()->ProcessCursor(renderer.GetWindow());
         renderer.DrawModels();
-        //renderer.PostProcessing();
+        renderer.PostProcessing();
         renderer.SwapBuffers();
-        renderer.PollEvents();
 
+        PROFILE_END_FRAME();
+        scheduler.EndFrame();
     }
 
     return 0;
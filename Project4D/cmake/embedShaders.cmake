@@ -0,0 +1,36 @@
+﻿# Генерация заголовка со всеми шейдерами в виде constexpr-таблицы.
+# Вызов: cmake -DSHADER_DIR=<каталог> -DOUTPUT=<файл> -P embedShaders.cmake
+#
+# Исходник режется на куски по 8000 символов: MSVC ограничивает длину одного строкового литерала,
+# а соседние литералы компилятор склеивает сам. Комментарии в заголовке только ASCII —
+# кодировка шейдеров переносится в литералы как есть.
+
+file(GLOB SHADER_FILES "${SHADER_DIR}/*.vert" "${SHADER_DIR}/*.frag" "${SHADER_DIR}/*.geom" "${SHADER_DIR}/*.comp")
+list(SORT SHADER_FILES)
+
+set(CONTENT "// Generated by cmake/embedShaders.cmake\n")
+string(APPEND CONTENT "#ifndef EMBEDDED_SHADERS_H\n#define EMBEDDED_SHADERS_H\n\n#include <string_view>\n\n")
+string(APPEND CONTENT "struct EmbeddedShader {\n    std::string_view file;\n    std::string_view source;\n};\n\n")
+string(APPEND CONTENT "inline constexpr EmbeddedShader embeddedShaders[] = {\n")
+
+foreach(SHADER_FILE ${SHADER_FILES})
+    get_filename_component(SHADER_NAME "${SHADER_FILE}" NAME)
+    file(READ "${SHADER_FILE}" SOURCE)
+    string(LENGTH "${SOURCE}" SOURCE_LENGTH)
+
+    string(APPEND CONTENT "    { \"${SHADER_NAME}\",\n")
+    set(OFFSET 0)
+    while(OFFSET LESS SOURCE_LENGTH)
+        string(SUBSTRING "${SOURCE}" ${OFFSET} 8000 CHUNK)
+        string(APPEND CONTENT "        R\"P4D_SHADER(${CHUNK})P4D_SHADER\"\n")
+        math(EXPR OFFSET "${OFFSET} + 8000")
+    endwhile()
+    if(SOURCE_LENGTH EQUAL 0)
+        string(APPEND CONTENT "        \"\"\n")
+    endif()
+    string(APPEND CONTENT "    },\n")
+endforeach()
+
+string(APPEND CONTENT "};\n\n#endif\n")
+
+file(WRITE "${OUTPUT}" "${CONTENT}")
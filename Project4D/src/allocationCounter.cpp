@@ -0,0 +1,82 @@
+#include "allocationCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if PROJECT4D_COUNT_ALLOCATIONS
+
+static std::atomic<size_t> allocationCount{ 0 };
+static std::atomic<size_t> allocationBytes{ 0 };
+
+bool AllocationCounter::IsEnabled() { return true; }
+size_t AllocationCounter::GetCount() { return allocationCount.load(std::memory_order_relaxed); }
+size_t AllocationCounter::GetBytes() { return allocationBytes.load(std::memory_order_relaxed); }
+
+static void* CountedAllocate(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void* CountedAllocate(size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    size_t align = (size_t)alignment;
+    size = (std::max<size_t>(size, 1) + align - 1) & ~(align - 1);
+#ifdef _WIN32
+    return _aligned_malloc(size, align);
+#else
+    return std::aligned_alloc(align, size);
+#endif
+}
+
+static void CountedFree(void* pointer, std::align_val_t) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void* operator new(size_t size) {
+    if (void* pointer = CountedAllocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* pointer = CountedAllocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* pointer = CountedAllocate(size, alignment)) return pointer;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* pointer = CountedAllocate(size, alignment)) return pointer;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignment); }
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept { CountedFree(pointer, alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { CountedFree(pointer, alignment); }
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept { CountedFree(pointer, alignment); }
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept { CountedFree(pointer, alignment); }
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(pointer, alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(pointer, alignment); }
+
+#else
+
+bool AllocationCounter::IsEnabled() { return false; }
+size_t AllocationCounter::GetCount() { return 0; }
+size_t AllocationCounter::GetBytes() { return 0; }
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+//     . ,     PROJECT4D_COUNT_ALLOCATIONS=1
+// ( CMake PROJECT4D_ALLOCATION_COUNTER):  allocationCounter.cpp  operator new/delete
+class AllocationCounter {
+public:
+    static bool IsEnabled();
+    static size_t GetCount(); //     
+    static size_t GetBytes(); //     
+};
+
+//    : AllocationScope scope; ...; scope.GetCount()
+class AllocationScope {
+public:
+    AllocationScope() : start(AllocationCounter::GetCount()) {}
+    size_t GetCount() const { return AllocationCounter::GetCount() - start; }
+
+private:
+    size_t start;
+};
+
+#endif
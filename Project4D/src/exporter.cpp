@@ -0,0 +1,144 @@
+#include "exporter.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <charconv>
+#include <cstring>
+#include <cstdio>
+
+//       
+static void AppendNumber(std::vector<char>& buffer, float value) {
+    char temp[32];
+    auto result = std::to_chars(temp, temp + sizeof(temp), value);
+    buffer.insert(buffer.end(), temp, result.ptr);
+}
+
+static void AppendNumber(std::vector<char>& buffer, GLuint value) {
+    char temp[16];
+    auto result = std::to_chars(temp, temp + sizeof(temp), value);
+    buffer.insert(buffer.end(), temp, result.ptr);
+}
+
+static void AppendText(std::vector<char>& buffer, const char* text) {
+    buffer.insert(buffer.end(), text, text + std::strlen(text));
+}
+
+bool SliceExporter::ExportSlice(const Model4D& model, const std::string& path) {
+    if (format == ExportFormat::PLY) {
+        return WritePLY(model.GetSliceVertices(), model.GetIndices(), path);
+    }
+    return WriteOBJ(model.GetSliceVertices(), model.GetIndices(), path);
+}
+
+int SliceExporter::ExportSweep(Model4D& model, float wBegin, float wEnd, int count, const std::string& directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "  : " << directory << " (" << error.message() << ")" << std::endl;
+        return 0;
+    }
+
+    float oldWSlice = model.GetWSlice();
+    int written = 0;
+
+    //            
+    model.BuildSweepIndex(false);
+
+    //      ,     
+    for (int i = 0; i < count; ++i) {
+        float w = count > 1 ? wBegin + (wEnd - wBegin) * i / (count - 1) : wBegin;
+        model.SetWSlice(w);
+        model.GenerateSweptSlice(w);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "slice_%04d%s", i, GetExtension());
+        std::filesystem::path path = std::filesystem::path(directory) / name;
+
+        if (!ExportSlice(model, path.string())) {
+            break;
+        }
+        ++written;
+    }
+
+    model.SetWSlice(oldWSlice);
+    model.GenerateSlice(oldWSlice);
+    return written;
+}
+
+bool SliceExporter::WritePLY(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "  : " << path << std::endl;
+        return false;
+    }
+
+    size_t vertexCount = vertices.size() / 6;
+    size_t faceCount = indices.size() / 3;
+
+    buffer.clear();
+    AppendText(buffer, "ply\nformat binary_little_endian 1.0\ncomment Project4D slice\nelement vertex ");
+    AppendNumber(buffer, (GLuint)vertexCount);
+    AppendText(buffer, "\nproperty float x\nproperty float y\nproperty float z\n"
+                       "property float nx\nproperty float ny\nproperty float nz\nelement face ");
+    AppendNumber(buffer, (GLuint)faceCount);
+    AppendText(buffer, "\nproperty list uchar uint vertex_indices\nend_header\n");
+
+    //   [x, y, z, nx, ny, nz]     PLY
+    size_t vertexBytes = vertexCount * 6 * sizeof(GLfloat);
+    size_t offset = buffer.size();
+    buffer.resize(offset + vertexBytes + faceCount * (1 + 3 * sizeof(GLuint)));
+    std::memcpy(buffer.data() + offset, vertices.data(), vertexBytes);
+    offset += vertexBytes;
+
+    for (size_t i = 0; i < faceCount; ++i) {
+        buffer[offset++] = 3;
+        std::memcpy(buffer.data() + offset, &indices[i * 3], 3 * sizeof(GLuint));
+        offset += 3 * sizeof(GLuint);
+    }
+
+    file.write(buffer.data(), buffer.size());
+    return file.good();
+}
+
+bool SliceExporter::WriteOBJ(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "  : " << path << std::endl;
+        return false;
+    }
+
+    buffer.clear();
+    AppendText(buffer, "# Project4D slice\n");
+
+    for (size_t i = 0; i + 5 < vertices.size(); i += 6) {
+        AppendText(buffer, "v ");
+        AppendNumber(buffer, vertices[i]);
+        buffer.push_back(' ');
+        AppendNumber(buffer, vertices[i + 1]);
+        buffer.push_back(' ');
+        AppendNumber(buffer, vertices[i + 2]);
+        AppendText(buffer, "\nvn ");
+        AppendNumber(buffer, vertices[i + 3]);
+        buffer.push_back(' ');
+        AppendNumber(buffer, vertices[i + 4]);
+        buffer.push_back(' ');
+        AppendNumber(buffer, vertices[i + 5]);
+        buffer.push_back('\n');
+    }
+
+    //  OBJ   1,     
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        buffer.push_back('f');
+        for (size_t j = 0; j < 3; ++j) {
+            GLuint index = indices[i + j] + 1;
+            buffer.push_back(' ');
+            AppendNumber(buffer, index);
+            AppendText(buffer, "//");
+            AppendNumber(buffer, index);
+        }
+        buffer.push_back('\n');
+    }
+
+    file.write(buffer.data(), buffer.size());
+    return file.good();
+}
@@ -0,0 +1,32 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <string>
+#include <vector>
+#include "model4D.h"
+
+enum class ExportFormat {
+    PLY, //  PLY (little endian)
+    OBJ
+};
+
+//  3D- Model4D     
+class SliceExporter {
+public:
+    SliceExporter(ExportFormat format) : format(format) {}
+
+    bool ExportSlice(const Model4D& model, const std::string& path); //    
+    int ExportSweep(Model4D& model, float wBegin, float wEnd, int count, const std::string& directory); //   wSlice    
+
+    ExportFormat GetFormat() const { return format; }
+    const char* GetExtension() const { return format == ExportFormat::PLY ? ".ply" : ".obj"; }
+
+private:
+    ExportFormat format;
+    std::vector<char> buffer; //   ,       
+
+    bool WritePLY(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, const std::string& path);
+    bool WriteOBJ(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, const std::string& path);
+};
+
+#endif
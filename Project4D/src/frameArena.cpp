@@ -0,0 +1,65 @@
+#include "frameArena.h"
+#include <new>
+#include <algorithm>
+
+FrameArena::~FrameArena() {
+    FreeBlocks();
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment) {
+    bytes = std::max<size_t>(bytes, 1);
+
+    while (current < blocks.size()) {
+        Block& block = blocks[current];
+        size_t start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= block.size) {
+            offset = start + bytes;
+            used += bytes;
+            return block.data + start;
+        }
+        ++current; //     Reset
+        offset = 0;
+    }
+
+    //      
+    AddBlock(std::max(blockSize, bytes + alignment));
+    current = blocks.size() - 1;
+    return Allocate(bytes, alignment);
+}
+
+void FrameArena::Reset() {
+    if (blocks.size() > 1) {
+        //           
+        size_t total = capacity;
+        FreeBlocks();
+        AddBlock(total);
+    }
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+void FrameArena::Reserve(size_t bytes) {
+    if (blocks.size() == 1 && capacity >= bytes) {
+        Reset();
+        return;
+    }
+    FreeBlocks();
+    AddBlock(std::max(blockSize, bytes));
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+void FrameArena::AddBlock(size_t size) {
+    blocks.push_back({ static_cast<char*>(::operator new(size)), size });
+    capacity += size;
+}
+
+void FrameArena::FreeBlocks() {
+    for (const Block& block : blocks) {
+        ::operator delete(block.data);
+    }
+    blocks.clear();
+    capacity = 0;
+}
@@ -0,0 +1,42 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+//    :    ,    Reset   .
+//      ;    Reserve    ,     operator new
+class FrameArena {
+public:
+    FrameArena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+    FrameArena(const FrameArena& other) : blockSize(other.blockSize) {} //      
+    FrameArena& operator=(const FrameArena&) { return *this; }
+    ~FrameArena();
+
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    template <typename T>
+    T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); } //   
+    void Reset(); //   ;       ,    
+    void Reserve(size_t bytes); //     bytes;    ,    
+
+    size_t GetUsed() const { return used; }
+    size_t GetCapacity() const { return capacity; }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t blockSize;
+    size_t current = 0; // ,    
+    size_t offset = 0;  //    
+    size_t used = 0;
+    size_t capacity = 0;
+
+    void AddBlock(size_t size);
+    void FreeBlocks();
+};
+
+#endif
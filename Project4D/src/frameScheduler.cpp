@@ -0,0 +1,42 @@
+#include "frameScheduler.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+
+int FrameScheduler::BeginFrame() {
+    double now = glfwGetTime();
+    if (lastTime < 0.0) {
+        lastTime = now;
+        nextFrameTime = now;
+    }
+
+    //   (,  )      
+    frameTime = std::min(now - lastTime, maxSteps * fixedStep);
+    lastTime = now;
+    accumulator += frameTime;
+
+    int steps = std::min((int)(accumulator / fixedStep), maxSteps);
+    accumulator -= steps * fixedStep;
+    accumulator = std::min(std::max(accumulator, 0.0), fixedStep * 0.999);
+    return steps;
+}
+
+void FrameScheduler::EndFrame() {
+    if (frameCap <= 0.0) {
+        return;
+    }
+
+    //    ,    :  sleep_for  1 
+    nextFrameTime += 1.0 / frameCap;
+    double now = glfwGetTime();
+    if (nextFrameTime - now > 0.002) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(nextFrameTime - now - 0.001));
+    }
+    while (glfwGetTime() < nextFrameTime) {
+        std::this_thread::yield();
+    }
+
+    //    ,    
+    nextFrameTime = std::max(nextFrameTime, glfwGetTime());
+}
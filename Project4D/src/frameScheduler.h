@@ -0,0 +1,32 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+//  :    ,     .
+//         
+class FrameScheduler {
+public:
+    FrameScheduler(double fixedStep = 1.0 / 120.0) : fixedStep(fixedStep) {}
+
+    void SetFixedStep(double step) { fixedStep = step; }
+    void SetFrameCap(double framesPerSecond) { frameCap = framesPerSecond; } // 0   
+    void SetMaxStepsPerFrame(int steps) { maxSteps = steps; } //       
+
+    int BeginFrame(); //   ,      
+    void EndFrame();  //       
+
+    double GetFixedStep() const { return fixedStep; }
+    float GetAlpha() const { return (float)(accumulator / fixedStep); } //      , [0, 1)
+    double GetFrameTime() const { return frameTime; } //    
+
+private:
+    double fixedStep;
+    double frameCap = 0.0;
+    int maxSteps = 8;
+
+    double accumulator = 0.0;
+    double lastTime = -1.0;
+    double frameTime = 0.0;
+    double nextFrameTime = 0.0;
+};
+
+#endif
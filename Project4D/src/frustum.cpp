@@ -0,0 +1,81 @@
+#include "frustum.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+void Frustum::Update(const glm::mat4& viewProjection) {
+    //   (glm  )
+    glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    glm::vec4 planes[8] = {
+        row3 + row0, // 
+        row3 - row0, // 
+        row3 + row1, // 
+        row3 - row1, // 
+        row3 + row2, // 
+        row3 - row2, // 
+        glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+        glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)
+    };
+
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 plane = planes[i];
+        if (i < 6) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        planeX[i] = plane.x;
+        planeY[i] = plane.y;
+        planeZ[i] = plane.z;
+        planeW[i] = plane.w;
+    }
+}
+
+bool Frustum::IsBoxOutside(const glm::vec3& center, const glm::vec3& extent) const {
+    //   ,       :
+    // dot(n, center) + w + dot(|n|, extent) < 0
+#ifdef FRUSTUM_SSE
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+    __m128 ex = _mm_set1_ps(extent.x), ey = _mm_set1_ps(extent.y), ez = _mm_set1_ps(extent.z);
+    int outsideMask = 0;
+
+    for (int i = 0; i < 8; i += 4) {
+        __m128 nx = _mm_load_ps(planeX + i), ny = _mm_load_ps(planeY + i), nz = _mm_load_ps(planeZ + i);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                                     _mm_add_ps(_mm_mul_ps(nz, cz), _mm_load_ps(planeW + i)));
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+                                              _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+                                   _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+        outsideMask |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+    }
+    return outsideMask != 0;
+#else
+    for (int i = 0; i < 8; ++i) {
+        float distance = planeX[i] * center.x + planeY[i] * center.y + planeZ[i] * center.z + planeW[i];
+        float radius = std::abs(planeX[i]) * extent.x + std::abs(planeY[i]) * extent.y + std::abs(planeZ[i]) * extent.z;
+        if (distance + radius < 0.0f) {
+            return true;
+        }
+    }
+    return false;
+#endif
+}
+
+bool Frustum::IsBoxVisible(const glm::vec3& min, const glm::vec3& max, const glm::mat4& model) const {
+    //  AABB   :   ,    
+    glm::vec3 center = glm::vec3(model * glm::vec4((min + max) * 0.5f, 1.0f));
+    glm::vec3 halfSize = (max - min) * 0.5f;
+    glm::vec3 extent(
+        std::abs(model[0][0]) * halfSize.x + std::abs(model[1][0]) * halfSize.y + std::abs(model[2][0]) * halfSize.z,
+        std::abs(model[0][1]) * halfSize.x + std::abs(model[1][1]) * halfSize.y + std::abs(model[2][1]) * halfSize.z,
+        std::abs(model[0][2]) * halfSize.x + std::abs(model[1][2]) * halfSize.y + std::abs(model[2][2]) * halfSize.z
+    );
+
+    return !IsBoxOutside(center, extent);
+}
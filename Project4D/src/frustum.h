@@ -0,0 +1,23 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+//      
+class Frustum {
+public:
+    void Update(const glm::mat4& viewProjection); //     projection * view
+    bool IsBoxVisible(const glm::vec3& min, const glm::vec3& max, const glm::mat4& model) const; //  AABB   
+
+private:
+    //       SIMD: xyz   , w  .
+    //      ,    
+    alignas(16) float planeX[8];
+    alignas(16) float planeY[8];
+    alignas(16) float planeZ[8];
+    alignas(16) float planeW[8];
+
+    bool IsBoxOutside(const glm::vec3& center, const glm::vec3& extent) const; // AABB   :   
+};
+
+#endif
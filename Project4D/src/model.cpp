@@ -1,4 +1,6 @@
 #include "model.h"
+#include "profiler.h"
+#include "rotation4D.h"
 #include <iostream>
 
 void Model::LoadModelData() {
@@ -46,10 +48,35 @@ void Model::LoadModelData() {
             20, 21, 22, 22, 23, 20
         };
     }
+
+    UpdateBounds();
+}
+
+void Model::UpdateBounds() {
+    boundsMin = glm::vec3(0.0f);
+    boundsMax = glm::vec3(0.0f);
+    for (size_t i = 0; i + 5 < vertices.size(); i += 6) {
+        glm::vec3 point(vertices[i], vertices[i + 1], vertices[i + 2]);
+        if (i == 0) {
+            boundsMin = boundsMax = point;
+        }
+        boundsMin = glm::min(boundsMin, point);
+        boundsMax = glm::max(boundsMax, point);
+    }
+}
+
+bool Model::GetLocalBounds(glm::vec3& min, glm::vec3& max) const {
+    if (indices.empty()) {
+        return false;
+    }
+    min = boundsMin;
+    max = boundsMax;
+    return true;
 }
 
 
 void Model::InitBuffers() {
+    PROFILE_SCOPE(ProfileStage::Upload);
 
     if (VAO != 0) {
         glDeleteVertexArrays(1, &VAO);
@@ -87,16 +114,9 @@ void Model::InitBuffers() {
 
 void Model::Rotate(float xy, float xz, float yz, double dt) {
 
-    xy *= glm::radians(1.0f) * dt * 100;
-    xz *= glm::radians(1.0f) * dt * 100;
-    yz *= glm::radians(1.0f) * dt * 100;
-    if (abs(xy) > 1 || abs(xz) > 1 || abs(yz) > 1) return;
-
-    glm::mat3 rotMat = glm::mat3(
-        glm::vec3(cos(xy) * cos(xz), -sin(xy) * cos(yz) + cos(xy) * sin(xz) * sin(yz), sin(xy) * sin(yz) + cos(xy) * sin(xz) * cos(yz)),
-        glm::vec3(sin(xy) * cos(xz), cos(xy) * cos(yz) + sin(xy) * sin(xz) * sin(yz), -cos(xy) * sin(yz) + sin(xy) * sin(xz) * cos(yz)),
-        glm::vec3(-sin(xz), cos(xz) * sin(yz), cos(xz) * cos(yz))
-    );
+    //     :       
+    float scale = glm::radians(1.0f) * (float)dt * 100;
+    glm::mat3 rotMat = glm::mat3(Rotation4D::Exp(Bivector4D(xy, xz, yz, 0.0f, 0.0f, 0.0f) * scale).ToMatrix());
 
     for (int i = 0;i < vertices.size() - 5;) {
         glm::vec3 rotated = rotMat * glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]);
@@ -106,6 +126,7 @@ void Model::Rotate(float xy, float xz, float yz, double dt) {
         i += 6;
     }
 
+    UpdateBounds();
     InitBuffers();
 }
 
@@ -117,6 +138,6 @@ void Model::Translate(glm::vec3 translation, glm::vec4 translation4D = glm::vec4
         vertices[i + 2] += translation.z;
     }
 
-
+    UpdateBounds();
     InitBuffers();
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ public:
         : type(type), position(position), size(size), color(color) {
         LoadModelData();
     }
+    virtual ~Model() = default; //    Model*
 
     ModelType GetType() const { return type; }
     glm::vec3 GetPosition() const { return position; }
@@ -25,6 +26,7 @@ public:
 
     const std::vector<GLfloat>& GetVertices() const { return vertices; }
     const std::vector<GLuint>& GetIndices() const { return indices; }
+    virtual bool GetLocalBounds(glm::vec3& min, glm::vec3& max) const; //     ; false,   
 
     GLuint GetVAO() const { return VAO; }
     GLuint GetVBO() const { return VBO; }
@@ -44,7 +46,11 @@ protected:
     glm::vec3 color;
     std::vector<GLfloat> vertices;
     std::vector<GLuint> indices;
-    GLuint VAO, VBO, EBO;
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    void UpdateBounds(); //     
 
 private:
     void LoadModelData();
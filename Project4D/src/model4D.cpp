@@ -1,4 +1,5 @@
 #include "model4D.h"
+#include "profiler.h"
 #include <iostream>
 #include <array>
 #include <vector>
@@ -6,16 +7,19 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
+#include <cstring>
 #include <glm/glm.hpp>
 #include <GL/glew.h>
 
 
 
+Model4D::~Model4D() {
+    ReleaseGPUBuffers();
+}
+
 void Model4D::LoadModel4DData() {
     vertices.clear();
     indices.clear();
-	adjacency.clear();
-	intersectionMap.clear();
 
     switch (type) {
         case(Model4DType::Tesseract):
@@ -45,241 +49,461 @@ void Model4D::LoadModel4DData() {
                 {0, 8}, {1, 9}, {2, 10}, {3, 11}, {4, 12}, {5, 13}, {6, 14}, {7, 15}  // 
             };
 
-            cells = {
-                {0, 1, 2, 3, 4, 5, 6, 7},    //  1:  
-                {8, 9, 10, 11, 12, 13, 14, 15}, //  2:  
-                {0, 3, 4, 7, 8, 11, 12, 15},  //  3: x = -1
-                {1, 2, 5, 6, 9, 10, 13, 14},  //  4: x = +1
-                {0, 1, 4, 5, 8, 9, 12, 13},   //  5: y = -1
-                {2, 3, 6, 7, 10, 11, 14, 15}, //  6: y = +1
-                {0, 1, 2, 3, 8, 9, 10, 11},   //  7: z = -1
-                {4, 5, 6, 7, 12, 13, 14, 15}  //  8: z = +1
+            cellVertices = {
+                0, 1, 2, 3, 4, 5, 6, 7,         //  1:  
+                8, 9, 10, 11, 12, 13, 14, 15,   //  2:  
+                0, 3, 4, 7, 8, 11, 12, 15,      //  3: x = -1
+                1, 2, 5, 6, 9, 10, 13, 14,      //  4: x = +1
+                0, 1, 4, 5, 8, 9, 12, 13,       //  5: y = -1
+                2, 3, 6, 7, 10, 11, 14, 15,     //  6: y = +1
+                0, 1, 2, 3, 8, 9, 10, 11,       //  7: z = -1
+                4, 5, 6, 7, 12, 13, 14, 15      //  8: z = +1
             };
+            cellOffsets = { 0, 8, 16, 24, 32, 40, 48, 56, 64 };
        }
+
+    //  ;      transform4D * rest + offset4D
+    restVertices = defVertices;
+    restRadius = 0.0f;
+    for (const auto& vertex : restVertices) {
+        restRadius = std::max(restRadius, glm::length(vertex));
+    }
+    transform4D = glm::mat4(1.0f);
+    offset4D = glm::vec4(0.0f);
+    stepRotation4D = previousRotation4D = Rotation4D();
+    stepOffset4D = previousOffset4D = offset4D;
+
+    BuildCellEdges();
+    BuildRidges();
+    BuildTetrahedra();
+
+    //     ,      
+    edgeVertex.assign(edges.size(), -1);
+    ridgeSegments.assign(ridgeEdgeOffsets.size() - 1, { -1, -1 });
+    cellTriangleCounts.assign(GetCellCount(), 0);
+    cellTriangles.resize(cellRidgeList.size());
+    kineticValid = false;
+
+    //        ,      :
+    //    ,    ,    
+    sliceEdges.reserve(edges.size());
+    vertices.reserve(edges.size() * 6);
+    edges3D.reserve(ridgeSegments.size());
+    indices.reserve(cellTriangles.size() * 3);
+    touchedCells.reserve(GetCellCount());
+    bvhCells.reserve(GetCellCount());
+    cellBounds.reserve(GetCellCount());
+    cellBVH.reserve(2 * GetCellCount()); //     
+    vertexSides.reserve(defVertices.size());
+    edgeBucketOffsets.reserve(edges.size() + 1);
+    edgeBucketEdges.reserve(edges.size() * EdgeBucketEntriesPerEdge);
+
+    // :   GenerateSliceIncremental + PatchSlice  BuildEdgeIndex,    
+    size_t incrementalBytes = defVertices.size() * sizeof(GLuint) + GetCellCount() * (sizeof(GLuint) + 1);
+    size_t indexBytes = edges.size() * sizeof(GLuint);
+    sliceArena.Reserve(std::max(incrementalBytes, indexBytes) + 3 * alignof(std::max_align_t));
 }
 
-void Model4D::Rotate4D(float xw, float yw, float zw, float dt) {
-    xw *= glm::radians(1.0f) * dt * 100;
-    yw *= glm::radians(1.0f) * dt * 100;
-    zw *= glm::radians(1.0f) * dt * 100;
-    if (abs(xw) > 1 || abs(yw) > 1 || abs(zw) > 1) return;
+void Model4D::BuildTetrahedra() {
+    tetrahedra.clear();
+    const float eps = 1e-5f;
+
+    for (size_t c = 0; c < GetCellCount(); ++c) {
+        auto cell = GetCell(c);
+        if (cell.size() < 4) continue;
+
+        //  3D-   (-)
+        glm::vec4 origin = restVertices[cell[0]];
+        std::vector<glm::vec4> basis;
+        for (size_t i = 1; i < cell.size() && basis.size() < 3; ++i) {
+            glm::vec4 d = restVertices[cell[i]] - origin;
+            for (const auto& b : basis) {
+                d -= glm::dot(d, b) * b;
+            }
+            if (glm::length(d) > eps) {
+                basis.push_back(glm::normalize(d));
+            }
+        }
+        if (basis.size() < 3) continue; //  
+
+        std::vector<glm::vec3> points;
+        for (GLuint v : cell) {
+            glm::vec4 d = restVertices[v] - origin;
+            points.emplace_back(glm::dot(d, basis[0]), glm::dot(d, basis[1]), glm::dot(d, basis[2]));
+        }
 
-    glm::mat4 rotMat = glm::mat4(
-        glm::vec4(cos(xw), -sin(xw) * sin(yw), -sin(xw) * cos(yw) * sin(zw), sin(xw) * cos(yw) * cos(zw)),
-        glm::vec4(0, cos(yw), -sin(yw) * sin(zw), sin(yw) * cos(zw)),
-        glm::vec4(0, 0, cos(zw), sin(zw)),
-        glm::vec4(-sin(xw), -cos(xw) * sin(yw), cos(xw) * -cos(yw) * sin(zw), cos(xw) * cos(yw) * cos(zw))
-    );
+        //    :    ,        
+        std::set<std::vector<size_t>> cellFaces;
+        size_t n = points.size();
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                for (size_t k = j + 1; k < n; ++k) {
+                    glm::vec3 normal = glm::cross(points[j] - points[i], points[k] - points[i]);
+                    if (glm::length(normal) < eps) continue;
+                    normal = glm::normalize(normal);
+
+                    bool above = false, below = false;
+                    std::vector<size_t> face;
+                    for (size_t m = 0; m < n; ++m) {
+                        float d = glm::dot(points[m] - points[i], normal);
+                        if (d > eps) above = true;
+                        else if (d < -eps) below = true;
+                        else face.push_back(m);
+                    }
+                    if (!(above && below)) {
+                        cellFaces.insert(face);
+                    }
+                }
+            }
+        }
 
-    for (auto& vertex : defVertices) {
-        vertex = rotMat * vertex;
+        //            
+        for (const auto& face : cellFaces) {
+            if (std::find(face.begin(), face.end(), 0) != face.end()) continue;
 
-		//std::cout << "Rotated Vertex: " << vertex.x << ", " << vertex.y << ", " << vertex.z << ", " << vertex.w << std::endl;
+            glm::vec3 center(0.0f);
+            for (size_t m : face) center += points[m];
+            center /= (float)face.size();
+
+            glm::vec3 normal = glm::normalize(glm::cross(points[face[1]] - points[face[0]], points[face[2]] - points[face[0]]));
+            glm::vec3 u = points[face[0]] - center;
+            glm::vec3 v = glm::cross(normal, u);
+
+            std::vector<std::pair<float, size_t>> ordered;
+            for (size_t m : face) {
+                glm::vec3 d = points[m] - center;
+                ordered.emplace_back(std::atan2(glm::dot(d, v), glm::dot(d, u)), m);
+            }
+            std::sort(ordered.begin(), ordered.end());
+
+            for (size_t m = 1; m + 1 < ordered.size(); ++m) {
+                tetrahedra.push_back(cell[0]);
+                tetrahedra.push_back(cell[ordered[0].second]);
+                tetrahedra.push_back(cell[ordered[m].second]);
+                tetrahedra.push_back(cell[ordered[m + 1].second]);
+            }
+        }
     }
+}
 
-    GenerateSlice(wSlice);
+void Model4D::UpdateVertices() {
+    //      , CPU   
+    if (sliceBackend == SliceBackend::Projection) {
+        return;
+    }
+
+    {
+        PROFILE_SCOPE(ProfileStage::Rotate);
+        for (size_t i = 0; i < restVertices.size(); ++i) {
+            defVertices[i] = transform4D * restVertices[i] + offset4D;
+        }
+    }
+
+    InvalidateSliceIndices();
 
+    if (sliceBackend == SliceBackend::CPU) {
+        GenerateSliceIncremental(wSlice);
+    }
+    else {
+        UpdateGPUSliceBounds(); //   GPU,  CPU     
+    }
 }
 
-bool Model4D::ArePointsConnectedByEdge(const glm::vec3& point1, const glm::vec3& point2) {
-    std::unordered_set<std::pair<glm::vec3, glm::vec3>, pair_hash> edgeSet;
-    for (const auto& edge : edges) {
-        edgeSet.insert({ glm::vec3(defVertices[edge[0]]), glm::vec3(defVertices[edge[1]]) });
-        edgeSet.insert({ glm::vec3(defVertices[edge[1]]), glm::vec3(defVertices[edge[0]]) });
+void Model4D::Rotate4D(float xw, float yw, float zw, float dt) {
+    StepRotate4D(xw, yw, zw, dt);
+    Interpolate(1.0f);
+}
+
+void Model4D::StepRotate4D(float xw, float yw, float zw, float dt) {
+    //       
+    StepRotate4D(Bivector4D(0.0f, 0.0f, 0.0f, xw, yw, zw) * (glm::radians(1.0f) * 100), dt);
+}
+
+void Model4D::StepRotate4D(const Bivector4D& angularVelocity, float dt) {
+    PROFILE_SCOPE(ProfileStage::Rotate);
+
+    //     ,     
+    Rotation4D step = Rotation4D::Exp(angularVelocity * dt);
+    glm::mat4 rotMat = step.ToMatrix();
+
+    //      ,        
+    previousRotation4D = stepRotation4D;
+    previousOffset4D = stepOffset4D;
+    stepRotation4D = step * stepRotation4D;
+    stepOffset4D = rotMat * stepOffset4D;
+}
+
+void Model4D::Interpolate(float alpha) {
+    if (alpha >= 1.0f) {
+        transform4D = stepRotation4D.ToMatrix();
+        offset4D = stepOffset4D;
+    }
+    else {
+        //       ,      
+        transform4D = Rotation4D::Slerp(previousRotation4D, stepRotation4D, alpha).ToMatrix();
+        offset4D = glm::mix(previousOffset4D, stepOffset4D, alpha);
     }
 
-    return edgeSet.find({ point1, point2 }) != edgeSet.end();
+    UpdateVertices();
 }
 
-std::vector<std::pair<GLuint, GLuint>> Model4D::GetCellEdges(const std::vector<GLuint>& cell) {
-    std::vector<std::pair<GLuint, GLuint>> cellEdges;
-    for (size_t i = 0; i < cell.size(); ++i) {
-        for (size_t j = i + 1; j < cell.size(); ++j) {
-            GLuint v1 = cell[i], v2 = cell[j];
-            // ,    (v1, v2)  edges
-            for (const auto& edge : edges) {
-                if ((edge[0] == v1 && edge[1] == v2) || (edge[0] == v2 && edge[1] == v1)) {
-                    cellEdges.emplace_back(std::min(v1, v2), std::max(v1, v2));
-                    break;
+void Model4D::BuildCellEdges() {
+    cellEdgeOffsets.assign(1, 0);
+    cellEdgeList.clear();
+
+    for (size_t c = 0; c < GetCellCount(); ++c) {
+        auto cell = GetCell(c);
+        for (size_t i = 0; i < cell.size(); ++i) {
+            for (size_t j = i + 1; j < cell.size(); ++j) {
+                GLuint v1 = cell[i], v2 = cell[j];
+                // ,    (v1, v2)  edges
+                for (GLuint e = 0; e < edges.size(); ++e) {
+                    if ((edges[e][0] == v1 && edges[e][1] == v2) || (edges[e][0] == v2 && edges[e][1] == v1)) {
+                        cellEdgeList.push_back(e);
+                        break;
+                    }
                 }
             }
         }
+        cellEdgeOffsets.push_back((GLuint)cellEdgeList.size());
+    }
+
+    //        (   CSR)
+    edgeCellOffsets.assign(edges.size() + 1, 0);
+    for (GLuint e : cellEdgeList) {
+        edgeCellOffsets[e + 1]++;
+    }
+    vertexEdgeOffsets.assign(defVertices.size() + 1, 0);
+    for (const auto& edge : edges) {
+        vertexEdgeOffsets[edge[0] + 1]++;
+        vertexEdgeOffsets[edge[1] + 1]++;
+    }
+    for (size_t e = 0; e < edges.size(); ++e) {
+        edgeCellOffsets[e + 1] += edgeCellOffsets[e];
+    }
+    for (size_t v = 0; v < defVertices.size(); ++v) {
+        vertexEdgeOffsets[v + 1] += vertexEdgeOffsets[v];
+    }
+
+    edgeCellList.resize(edgeCellOffsets.back());
+    std::vector<GLuint> fill(edgeCellOffsets.begin(), edgeCellOffsets.end() - 1);
+    for (GLuint c = 0; c < GetCellCount(); ++c) {
+        for (GLuint i = cellEdgeOffsets[c]; i < cellEdgeOffsets[c + 1]; ++i) {
+            edgeCellList[fill[cellEdgeList[i]]++] = c;
+        }
+    }
+    vertexEdgeList.resize(vertexEdgeOffsets.back());
+    fill.assign(vertexEdgeOffsets.begin(), vertexEdgeOffsets.end() - 1);
+    for (GLuint e = 0; e < edges.size(); ++e) {
+        vertexEdgeList[fill[edges[e][0]]++] = e;
+        vertexEdgeList[fill[edges[e][1]]++] = e;
     }
-    return cellEdges;
 }
 
-void Model4D::ComputeAdjacentEdges() {
-    adjacentEdges.clear();
-    for (const auto& cell : cells) {
-        auto cellEdges = GetCellEdges(cell);
-        for (size_t i = 0; i < cellEdges.size(); ++i) {
-            for (size_t j = i + 1; j < cellEdges.size(); ++j) {
-                auto edge1 = cellEdges[i];
-                auto edge2 = cellEdges[j];
-                adjacentEdges[edge1].insert(edge2);
-                adjacentEdges[edge2].insert(edge1);
+void Model4D::BuildRidges() {
+    ridgeEdgeOffsets.assign(1, 0);
+    ridgeEdgeList.clear();
+    ridgeTriangles.clear();
+
+    //       ,        
+    std::vector<GLuint> shared, polygon;
+    std::vector<std::array<GLuint, 2>> ridgeCells;
+    for (size_t c1 = 0; c1 < GetCellCount(); ++c1) {
+        for (size_t c2 = c1 + 1; c2 < GetCellCount(); ++c2) {
+            auto cell1 = GetCell(c1), cell2 = GetCell(c2);
+            shared.clear();
+            for (GLuint v : cell1) {
+                if (std::find(cell2.begin(), cell2.end(), v) != cell2.end()) {
+                    shared.push_back(v);
+                }
+            }
+            if (shared.size() < 3) continue;
+
+            //          
+            for (GLuint e = 0; e < edges.size(); ++e) {
+                if (std::find(shared.begin(), shared.end(), edges[e][0]) != shared.end() &&
+                    std::find(shared.begin(), shared.end(), edges[e][1]) != shared.end()) {
+                    ridgeEdgeList.push_back(e);
+                }
+            }
+            GLuint first = ridgeEdgeOffsets.back(), last = (GLuint)ridgeEdgeList.size();
+            ridgeEdgeOffsets.push_back(last);
+            ridgeCells.push_back({ (GLuint)c1, (GLuint)c2 });
+            if (first == last) continue;
+
+            //    ,      
+            GLuint start = edges[ridgeEdgeList[first]][0];
+            GLuint previous = start, current = edges[ridgeEdgeList[first]][1];
+            polygon.assign(1, start);
+            while (current != start && polygon.size() < shared.size()) {
+                polygon.push_back(current);
+                GLuint next = current;
+                for (GLuint i = first; i < last && next == current; ++i) {
+                    const auto& edge = edges[ridgeEdgeList[i]];
+                    GLuint other = edge[0] == current ? edge[1] : edge[1] == current ? edge[0] : current;
+                    if (other != current && other != previous) {
+                        next = other;
+                    }
+                }
+                if (next == current) break; //     
+                previous = current;
+                current = next;
+            }
+            for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+                ridgeTriangles.insert(ridgeTriangles.end(), { polygon[0], polygon[i], polygon[i + 1] });
             }
         }
     }
+
+    //  :    (   CSR)
+    cellRidgeOffsets.assign(GetCellCount() + 1, 0);
+    for (const auto& cells : ridgeCells) {
+        cellRidgeOffsets[cells[0] + 1]++;
+        cellRidgeOffsets[cells[1] + 1]++;
+    }
+    for (size_t c = 0; c < GetCellCount(); ++c) {
+        cellRidgeOffsets[c + 1] += cellRidgeOffsets[c];
+    }
+    cellRidgeList.resize(cellRidgeOffsets.back());
+    std::vector<GLuint> fill(cellRidgeOffsets.begin(), cellRidgeOffsets.end() - 1);
+    for (GLuint r = 0; r < ridgeCells.size(); ++r) {
+        cellRidgeList[fill[ridgeCells[r][0]]++] = r;
+        cellRidgeList[fill[ridgeCells[r][1]]++] = r;
+    }
 }
 
 bool IntersectPlane(const glm::vec4& v1, const glm::vec4& v2, float wSlice, glm::vec3& intersection) {
     float w1 = v1.w, w2 = v2.w;
 
-    //    0
-    if (w1 == w2) return false;
+    // :       .   
+    //     ,          
+    if ((w1 < wSlice) == (w2 < wSlice)) return false;
 
     float t = (wSlice - w1) / (w2 - w1);
-
-    // ,     
-    if (t >= 0.0f && t <= 1.0f) {
-        intersection.x = v1.x + t * (v2.x - v1.x);
-        intersection.y = v1.y + t * (v2.y - v1.y);
-        intersection.z = v1.z + t * (v2.z - v1.z);
-        return true;
-    }
-    return false;
+    intersection.x = v1.x + t * (v2.x - v1.x);
+    intersection.y = v1.y + t * (v2.y - v1.y);
+    intersection.z = v1.z + t * (v2.z - v1.z);
+    return true;
 }
 
 void Model4D::GenerateSlice(float wSlice) {
+    PROFILE_SCOPE(ProfileStage::Slice);
 
+    kineticValid = false;
     vertices.clear();
-    intersectionMap.clear();
-    adjacency.clear();
-    int indexCounter = 0;
-
-    std::map<std::pair<GLuint, GLuint>, glm::vec3> edgeIntersections;
-
-    
-    for (auto& edge : edges) {
-
-        /*for (auto& point : edge) {
-            for (auto& otherPoint : edge) {
-                if ((point != otherPoint)) {
-                    std::vector<GLuint> edge3D = { point, otherPoint };
-                    std::sort(begin(edge3D), end(edge3D));
-                    if (std::find(edges3D.begin(), edges3D.end(), edge3D) == edges3D.end()) {
-                        edges3D.push_back(edge3D);
-                    }
-                }
-            }
-        }
-
-        glm::vec3 intersection;
+    sliceEdges.clear();
+    sliceArena.Reset(); //       
+
+    //     
+    std::fill(edgeVertex.begin(), edgeVertex.end(), -1);
+    std::fill(ridgeSegments.begin(), ridgeSegments.end(), std::array<int, 2>{ -1, -1 });
+    std::fill(cellTriangleCounts.begin(), cellTriangleCounts.end(), 0);
+
+    //       ,    
+    const AABB4D& bounds = GetBounds4D();
+    if (wSlice < bounds.min.w || wSlice > bounds.max.w) {
+        indices.clear();
+        edges3D.clear();
+        UpdateBounds();
+        return;
+    }
 
-        if (IntersectPlane(defVertices[edge[0]], defVertices[edge[1]], wSlice, intersection)) {
+    //   w ,          (  w, ).
+    //        :      
+    if (!edgeIndexValid && !poseChanged) {
+        BuildEdgeIndex();
+    }
+    poseChanged = false;
 
-            if (intersectionMap.find(intersection) == intersectionMap.end()) {
-                intersectionMap[intersection] = indexCounter++;
-                vertices.push_back(intersection.x);
-                vertices.push_back(intersection.y);
-                vertices.push_back(intersection.z);
-                vertices.push_back(1); //
-                vertices.push_back(1); // 
-                vertices.push_back(0); //
-            }
+    //   ,    w   wSlice
+    size_t bucketBegin = 0, bucketEnd = edges.size();
+    if (edgeIndexValid) {
+        FindEdgeBucket(wSlice, bucketBegin, bucketEnd);
+    }
 
-        }*/
+    for (size_t i = bucketBegin; i < bucketEnd; ++i) {
+        GLuint e = edgeIndexValid ? edgeBucketEdges[i] : (GLuint)i;
+        auto& edge = edges[e];
 
         glm::vec3 intersection;
         if (IntersectPlane(defVertices[edge[0]], defVertices[edge[1]], wSlice, intersection)) {
-            edgeIntersections[{edge[0], edge[1]}] = intersection;
-            if (intersectionMap.find(intersection) == intersectionMap.end()) {
-                intersectionMap[intersection] = indexCounter++;
-                vertices.push_back(intersection.x);
-                vertices.push_back(intersection.y);
-                vertices.push_back(intersection.z);
-                vertices.push_back(1);
-                vertices.push_back(1); // 
-                vertices.push_back(1);
-            }
+            edgeVertex[e] = (int)sliceEdges.size();
+            sliceEdges.push_back(e);
+            vertices.push_back(intersection.x);
+            vertices.push_back(intersection.y);
+            vertices.push_back(intersection.z);
+            vertices.push_back(1);
+            vertices.push_back(1); // 
+            vertices.push_back(1);
         }
-     }
+    }
 
+    //      :          
+    for (GLuint r = 0; r < ridgeSegments.size(); ++r) {
+        UpdateRidgeSegment(r);
+    }
 
-    ComputeAdjacentEdges(); //   
+    //    ,  
+    touchedCells.clear();
+    QueryCellBVH(wSlice, touchedCells);
+    for (GLuint cellIndex : touchedCells) {
+        BuildCellFan(cellIndex);
+    }
 
-    /*for (auto& ad : adjacentEdges) {
-        std::cout << ad.first.first << " " << ad.first.second << ": ";
-			for (auto& a : ad.second) {
-				std::cout << "(" << a.first << ", " << a.second << ") ";
-			}
-            std::cout << std::endl;
-    }*/
+    GenerateEdges3D();
+    GenerateIndices();
+    UpdateBounds();
+}
 
-    for (const auto& [edge1, point1] : edgeIntersections) {
-        for (const auto& [edge2, point2] : edgeIntersections) {
-            if (edge1 == edge2 || point1 == point2) continue;
-            auto e1 = std::make_pair(std::min(edge1.first, edge1.second), std::max(edge1.first, edge1.second));
-            auto e2 = std::make_pair(std::min(edge2.first, edge2.second), std::max(edge2.first, edge2.second));
-            if (adjacentEdges[e1].count(e2) > 0) {
-                //   
-                GLuint idx1 = intersectionMap[point1];
-                GLuint idx2 = intersectionMap[point2];
-                adjacency[idx1].insert(idx2);
-                adjacency[idx2].insert(idx1);
-                std::vector<GLuint> edge3D = { idx1, idx2 };
-                std::sort(edge3D.begin(), edge3D.end());
-                if (std::find(edges3D.begin(), edges3D.end(), edge3D) == edges3D.end()) {
-                    edges3D.push_back(edge3D);
-                }
-            }
+void Model4D::UpdateRidgeSegment(GLuint ridge) {
+    //         
+    std::array<int, 2> segment = { -1, -1 };
+    for (GLuint i = ridgeEdgeOffsets[ridge]; i < ridgeEdgeOffsets[ridge + 1]; ++i) {
+        int v = edgeVertex[ridgeEdgeList[i]];
+        if (v >= 0) {
+            segment[segment[0] < 0 ? 0 : 1] = v;
         }
     }
+    ridgeSegments[ridge] = segment;
+}
 
-    for (auto& [point, index] : intersectionMap) {
-        //std::cout << "Point: " << point.x << ", " << point.y << ", " << point.z << "   " << index << std::endl;
-        for (auto& [otherPoint, otherIndex] : intersectionMap) {
-            if ((point != otherPoint) && ArePointsConnectedByEdge(point, otherPoint)) {
-                adjacency[index].insert(otherIndex);
-                adjacency[otherIndex].insert(index);
-            }
+void Model4D::BuildCellFan(GLuint cell) {
+    //      ,      .
+    //    :  ,   ,  
+    std::array<GLuint, 3>* triangles = &cellTriangles[cellRidgeOffsets[cell]];
+    GLuint count = 0;
+    int first = -1;
+    for (GLuint i = cellRidgeOffsets[cell]; i < cellRidgeOffsets[cell + 1]; ++i) {
+        const std::array<int, 2>& segment = ridgeSegments[cellRidgeList[i]];
+        if (segment[1] < 0) continue;
+        if (first < 0) {
+            first = segment[0];
         }
-    }
-
-    /*for (auto& ad : adjacency) {
-        std::cout << "Vertex " << ad.first << ": ";
-        for (auto& neighbor : ad.second) {
-            std::cout << neighbor << " ";
+        else if (segment[0] != first && segment[1] != first) {
+            triangles[count++] = { (GLuint)first, (GLuint)segment[0], (GLuint)segment[1] };
         }
-        std::cout << std::endl;
     }
+    cellTriangleCounts[cell] = count;
+}
 
-    for (const auto& [edge, adj] : adjacentEdges) {
-        std::cout << "Edge (" << edge.first << ", " << edge.second << "): ";
-        for (const auto& a : adj) {
-            std::cout << "(" << a.first << ", " << a.second << ") ";
+void Model4D::GenerateEdges3D() {
+    //     ,          
+    edges3D.clear();
+    for (const auto& segment : ridgeSegments) {
+        if (segment[1] >= 0) {
+            edges3D.push_back({ (uint32_t)std::min(segment[0], segment[1]), (uint32_t)std::max(segment[0], segment[1]) });
         }
-        std::cout << std::endl;
-    }*/
-
-    GenerateIndices();
+    }
 }
 
 void Model4D::GenerateIndices() {
+    PROFILE_SCOPE(ProfileStage::Indices);
     indices.clear();
-    faces.clear();
-    
-    std::unordered_set<int> visited;
-
-    for (const auto& [index, neighbors] : adjacency) { // 
-        for (int neighbor : neighbors) {
-            for (int third : adjacency[neighbor]) {
-
-                if (third != index && (adjacency[index].count(third) || (adjacency[neighbor].count(third)))) {
 
-                    std::array<int, 3> face = { index, neighbor, third };
-                    std::sort(face.begin(), face.end());
-
-                    if (visited.count(face[0] * 10000 + face[1] * 100 + face[2]) == 0) { //     visited 012
-                        indices.push_back(face[0]);
-                        indices.push_back(face[1]);
-                        indices.push_back(face[2]); 
-                        faces.push_back({face[0], face[1], face[2]});
-                        visited.insert(face[0] * 10000 + face[1] * 100 + face[2]);
-                    }
-                }
-            }
+    for (GLuint c = 0; c < GetCellCount(); ++c) {
+        const std::array<GLuint, 3>* triangles = &cellTriangles[cellRidgeOffsets[c]];
+        for (GLuint i = 0; i < cellTriangleCounts[c]; ++i) {
+            indices.insert(indices.end(), triangles[i].begin(), triangles[i].end());
         }
     }
 
@@ -343,18 +567,430 @@ void Model4D::GenerateIndices() {
 
 }
 
-void Model4D::Translate(glm::vec3 translation = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec4 translation4D = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)) {
+void Model4D::BuildEdgeIndex() {
+    edgeBucketOffsets.clear();
+    edgeBucketEdges.clear();
+    edgeIndexValid = true;
 
-    for (auto& vertex : defVertices) {
-        vertex += translation4D;
+    if (defVertices.empty() || edges.empty()) {
+        edgeBucketOffsets.assign(2, 0);
+        edgeBucketMin = edgeBucketScale = 0.0f;
+        return;
     }
 
-    GenerateSlice(wSlice);
+    float wMin = defVertices[0].w, wMax = defVertices[0].w;
+    for (const auto& vertex : defVertices) {
+        wMin = std::min(wMin, vertex.w);
+        wMax = std::max(wMax, vertex.w);
+    }
 
+    //     w,     .   dw 
+    //     bucketCount * dw / (wMax - wMin) + 2 ,      :
+    //     EdgeBucketEntriesPerEdge          
+    float spanSum = 0.0f;
+    if (wMax > wMin) {
+        for (const auto& edge : edges) {
+            spanSum += std::abs(defVertices[edge[0]].w - defVertices[edge[1]].w) / (wMax - wMin);
+        }
+    }
+    size_t bucketCount = std::max<size_t>(1, edges.size());
+    size_t spanBudget = edges.size() * (EdgeBucketEntriesPerEdge - 3); //         
+    if (spanSum * bucketCount > spanBudget) {
+        bucketCount = std::max<size_t>(1, (size_t)(spanBudget / spanSum));
+    }
+    edgeBucketMin = wMin;
+    edgeBucketScale = wMax > wMin ? bucketCount / (wMax - wMin) : 0.0f;
+    edgeBucketOffsets.assign(bucketCount + 1, 0);
+
+    auto bucketOf = [&](float w) {
+        size_t bucket = (size_t)((w - edgeBucketMin) * edgeBucketScale);
+        return std::min(bucket, bucketCount - 1);
+    };
+
+    //  :    ,   (   CSR)
+    for (const auto& edge : edges) {
+        float w1 = defVertices[edge[0]].w, w2 = defVertices[edge[1]].w;
+        if (w1 == w2) continue; // IntersectPlane    
+        size_t first = bucketOf(std::min(w1, w2)), last = bucketOf(std::max(w1, w2));
+        for (size_t b = first; b <= last; ++b) {
+            edgeBucketOffsets[b + 1]++;
+        }
+    }
+    for (size_t b = 0; b < bucketCount; ++b) {
+        edgeBucketOffsets[b + 1] += edgeBucketOffsets[b];
+    }
+
+    edgeBucketEdges.resize(edgeBucketOffsets[bucketCount]);
+    GLuint* fill = sliceArena.AllocateArray<GLuint>(bucketCount);
+    std::copy(edgeBucketOffsets.begin(), edgeBucketOffsets.end() - 1, fill);
+    for (GLuint e = 0; e < edges.size(); ++e) {
+        float w1 = defVertices[edges[e][0]].w, w2 = defVertices[edges[e][1]].w;
+        if (w1 == w2) continue;
+        size_t first = bucketOf(std::min(w1, w2)), last = bucketOf(std::max(w1, w2));
+        for (size_t b = first; b <= last; ++b) {
+            edgeBucketEdges[fill[b]++] = e; // и      
+        }
+    }
+}
+
+void Model4D::FindEdgeBucket(float wSlice, size_t& begin, size_t& end) const {
+    begin = end = 0;
+    size_t bucketCount = edgeBucketOffsets.size() - 1;
+    float offset = (wSlice - edgeBucketMin) * edgeBucketScale;
+    if (offset < 0.0f || offset > (float)bucketCount) {
+        return; // wSlice     w
+    }
+    size_t bucket = std::min((size_t)offset, bucketCount - 1);
+    begin = edgeBucketOffsets[bucket];
+    end = edgeBucketOffsets[bucket + 1];
+}
+
+const AABB4D& Model4D::GetBounds4D() {
+    if (!bounds4DValid) {
+        bounds4D = AABB4D();
+        for (const auto& vertex : defVertices) {
+            bounds4D.Expand(vertex);
+        }
+        bounds4DValid = true;
+    }
+    return bounds4D;
+}
+
+void Model4D::BuildCellBVH() {
+    cellBVH.clear();
+    bvhCells.resize(GetCellCount());
+    cellBounds.resize(GetCellCount());
+    cellBVHValid = true;
+
+    for (GLuint i = 0; i < GetCellCount(); ++i) {
+        bvhCells[i] = i;
+        cellBounds[i] = AABB4D();
+        for (GLuint v : GetCell(i)) {
+            cellBounds[i].Expand(defVertices[v]);
+        }
+    }
+
+    if (GetCellCount() > 0) {
+        BuildCellBVHNode(0, (GLuint)GetCellCount());
+    }
+}
+
+int Model4D::BuildCellBVHNode(GLuint first, GLuint count) {
+    int nodeIndex = (int)cellBVH.size();
+    cellBVH.emplace_back();
+
+    AABB4D nodeBounds;
+    for (GLuint i = first; i < first + count; ++i) {
+        nodeBounds.Expand(cellBounds[bvhCells[i]]);
+    }
+    cellBVH[nodeIndex].bounds = nodeBounds;
+
+    if (count <= 2) { // 
+        cellBVH[nodeIndex].first = first;
+        cellBVH[nodeIndex].count = count;
+        return nodeIndex;
+    }
+
+    //        
+    glm::vec4 extent = nodeBounds.max - nodeBounds.min;
+    int axis = 0;
+    for (int a = 1; a < 4; ++a) {
+        if (extent[a] > extent[axis]) axis = a;
+    }
+
+    GLuint half = count / 2;
+    std::nth_element(bvhCells.begin() + first, bvhCells.begin() + first + half, bvhCells.begin() + first + count,
+        [&](GLuint a, GLuint b) {
+            return cellBounds[a].min[axis] + cellBounds[a].max[axis] < cellBounds[b].min[axis] + cellBounds[b].max[axis];
+        });
+
+    int left = BuildCellBVHNode(first, half);
+    int right = BuildCellBVHNode(first + half, count - half);
+    cellBVH[nodeIndex].left = left;
+    cellBVH[nodeIndex].right = right;
+    return nodeIndex;
+}
+
+void Model4D::QueryCellBVH(float wSlice, std::vector<GLuint>& result) {
+    if (!cellBVHValid) {
+        BuildCellBVH();
+    }
+    if (cellBVH.empty()) {
+        return;
+    }
+
+    //   ;  ,      
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const CellBVHNode& node = cellBVH[stack[--stackSize]];
+        if (wSlice < node.bounds.min.w || wSlice > node.bounds.max.w) continue;
+
+        if (node.left < 0) {
+            for (GLuint i = node.first; i < node.first + node.count; ++i) {
+                const AABB4D& cell = cellBounds[bvhCells[i]];
+                if (wSlice >= cell.min.w && wSlice <= cell.max.w) {
+                    result.push_back(bvhCells[i]);
+                }
+            }
+        }
+        else {
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.right;
+        }
+    }
+    std::sort(result.begin(), result.end());
+}
+
+void Model4D::InvalidateSliceIndices() {
+    bounds4DValid = false;
+    cellBVHValid = false;
+    edgeIndexValid = false;
+    poseChanged = true;
+    sweepValid = false;
+    sweepBreakpoints.clear();
+    sweepIntervals.clear();
+}
+
+void Model4D::BuildSweepIndex(bool precomputeAll) {
+    //     w- 
+    sweepBreakpoints.clear();
+    for (const auto& vertex : defVertices) {
+        sweepBreakpoints.push_back(vertex.w);
+    }
+    std::sort(sweepBreakpoints.begin(), sweepBreakpoints.end());
+    sweepBreakpoints.erase(std::unique(sweepBreakpoints.begin(), sweepBreakpoints.end()), sweepBreakpoints.end());
+
+    //    ,  ;   
+    sweepIntervals.assign(sweepBreakpoints.size() + 1, SweepInterval());
+    sweepIntervals.front().built = true;
+    sweepIntervals.back().built = true;
+    sweepValid = true;
+
+    if (precomputeAll) {
+        for (size_t i = 1; i + 1 < sweepIntervals.size(); ++i) {
+            BuildSweepInterval(i);
+        }
+    }
+}
+
+void Model4D::BuildSweepInterval(size_t interval) {
+    SweepInterval& sweep = sweepIntervals[interval];
+
+    //         , 
+    //        ,   
+    float wMid = 0.5f * (sweepBreakpoints[interval - 1] + sweepBreakpoints[interval]);
+    SwapSliceState(sweepScratch); //   ,     
+    GenerateSlice(wMid);
+
+    sweep.indices = indices;
+    sweep.origins.clear();
+    sweep.deltas.clear();
+    for (GLuint e : sliceEdges) {
+        const glm::vec4& p1 = defVertices[edges[e][0]];
+        const glm::vec4& p2 = defVertices[edges[e][1]];
+        //    w: origin.xyz + (w - origin.w) * delta.w * delta.xyz
+        sweep.origins.push_back(p1);
+        sweep.deltas.push_back(glm::vec4(glm::vec3(p2 - p1), 1.0f / (p2.w - p1.w)));
+    }
+    sweep.edges = sliceEdges;
+    sweep.edges3D = edges3D;
+    sweep.built = true;
+
+    SwapSliceState(sweepScratch);
+}
+
+void Model4D::SwapSliceState(SliceState& state) {
+    vertices.swap(state.vertices);
+    indices.swap(state.indices);
+    sliceEdges.swap(state.sliceEdges);
+    edges3D.swap(state.edges3D);
+    std::swap(boundsMin, state.boundsMin);
+    std::swap(boundsMax, state.boundsMax);
+}
+
+void Model4D::GenerateSweptSlice(float wSlice) {
+    PROFILE_SCOPE(ProfileStage::Slice);
+    if (!sweepValid) {
+        BuildSweepIndex(false);
+    }
+
+    auto it = std::upper_bound(sweepBreakpoints.begin(), sweepBreakpoints.end(), wSlice);
+    if (it != sweepBreakpoints.begin() && *(it - 1) == wSlice) {
+        GenerateSlice(wSlice); //       
+        return;
+    }
+
+    size_t interval = it - sweepBreakpoints.begin();
+    if (!sweepIntervals[interval].built) {
+        BuildSweepInterval(interval);
+    }
+
+    const SweepInterval& sweep = sweepIntervals[interval];
+    size_t count = sweep.origins.size();
+
+    //        
+    vertices.resize(count * 6);
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec4& origin = sweep.origins[i];
+        const glm::vec4& delta = sweep.deltas[i];
+        float t = (wSlice - origin.w) * delta.w;
+        GLfloat* vertex = &vertices[i * 6];
+        vertex[0] = origin.x + t * delta.x;
+        vertex[1] = origin.y + t * delta.y;
+        vertex[2] = origin.z + t * delta.z;
+        vertex[3] = 1;
+        vertex[4] = 1; // 
+        vertex[5] = 1;
+    }
+
+    indices = sweep.indices;
+    sliceEdges = sweep.edges;
+    edges3D = sweep.edges3D;
+    kineticValid = false;
+    UpdateBounds();
+}
+
+int Model4D::UpdateVertexSides(float wSlice, GLuint* crossedVertices) {
+    //        
+    vertexSides.resize(defVertices.size());
+    int count = 0;
+
+    for (GLuint i = 0; i < defVertices.size(); ++i) {
+        unsigned char side = defVertices[i].w < wSlice ? 0 : 1; // ,   IntersectPlane
+        if (vertexSides[i] != side) {
+            vertexSides[i] = side;
+            crossedVertices[count++] = i;
+        }
+    }
+    return count;
+}
+
+void Model4D::GenerateSliceIncremental(float wSlice) {
+    PROFILE_SCOPE(ProfileStage::Slice);
+    bool reuse = kineticValid && kineticWSlice == wSlice && vertexSides.size() == defVertices.size();
+
+    sliceArena.Reset();
+    GLuint* crossedVertices = sliceArena.AllocateArray<GLuint>(defVertices.size());
+    sliceEvents = UpdateVertexSides(wSlice, crossedVertices);
+
+    //      .    (,  ),
+    //   ,   
+    if (!reuse || (size_t)sliceEvents * 8 > defVertices.size()) {
+        GenerateSlice(wSlice);
+        kineticValid = true;
+        kineticWSlice = wSlice;
+        return;
+    }
+    if (sliceEvents > 0) {
+        PatchSlice(crossedVertices, sliceEvents);
+    }
+
+    //       
+    for (size_t i = 0; i < sliceEdges.size(); ++i) {
+        const glm::vec4& v1 = defVertices[edges[sliceEdges[i]][0]];
+        const glm::vec4& v2 = defVertices[edges[sliceEdges[i]][1]];
+        float t = (wSlice - v1.w) / (v2.w - v1.w); //   IntersectPlane,    
+        GLfloat* vertex = &vertices[i * 6];
+        vertex[0] = v1.x + t * (v2.x - v1.x);
+        vertex[1] = v1.y + t * (v2.y - v1.y);
+        vertex[2] = v1.z + t * (v2.z - v1.z);
+    }
+    UpdateBounds();
+}
+
+void Model4D::PatchSlice(const GLuint* crossedVertices, size_t count) {
+    // ,         
+    size_t cellCount = GetCellCount();
+    GLuint* dirtyCells = sliceArena.AllocateArray<GLuint>(cellCount);
+    unsigned char* dirty = sliceArena.AllocateArray<unsigned char>(cellCount);
+    std::fill(dirty, dirty + cellCount, 0);
+    size_t dirtyCount = 0;
+    auto markCells = [&](GLuint e) {
+        for (GLuint i = edgeCellOffsets[e]; i < edgeCellOffsets[e + 1]; ++i) {
+            GLuint cell = edgeCellList[i];
+            if (!dirty[cell]) {
+                dirty[cell] = 1;
+                dirtyCells[dirtyCount++] = cell;
+            }
+        }
+    };
+
+    //         ,  
+    for (size_t k = 0; k < count; ++k) {
+        GLuint v = crossedVertices[k];
+        for (GLuint i = vertexEdgeOffsets[v]; i < vertexEdgeOffsets[v + 1]; ++i) {
+            GLuint e = vertexEdgeList[i];
+            bool crosses = vertexSides[edges[e][0]] != vertexSides[edges[e][1]];
+            if (crosses == (edgeVertex[e] >= 0)) continue; //    
+            markCells(e);
+
+            if (crosses) {
+                edgeVertex[e] = (int)sliceEdges.size();
+                sliceEdges.push_back(e);
+                vertices.insert(vertices.end(), { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f }); //     
+            }
+            else {
+                //      ,     
+                GLuint removed = (GLuint)edgeVertex[e];
+                GLuint moved = sliceEdges.back();
+                sliceEdges[removed] = moved;
+                edgeVertex[moved] = (int)removed;
+                edgeVertex[e] = -1;
+                sliceEdges.pop_back();
+                vertices.resize(sliceEdges.size() * 6);
+                if (moved != e) {
+                    markCells(moved);
+                }
+            }
+        }
+    }
+
+    //    ,    ,  
+    for (size_t k = 0; k < dirtyCount; ++k) {
+        GLuint cell = dirtyCells[k];
+        for (GLuint i = cellRidgeOffsets[cell]; i < cellRidgeOffsets[cell + 1]; ++i) {
+            UpdateRidgeSegment(cellRidgeList[i]);
+        }
+    }
+    for (size_t k = 0; k < dirtyCount; ++k) {
+        BuildCellFan(dirtyCells[k]);
+    }
+
+    GenerateEdges3D();
+    GenerateIndices();
+}
+
+void Model4D::Translate(glm::vec3 translation = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec4 translation4D = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)) {
+
+    offset4D += translation4D;
+    stepOffset4D += translation4D;
+    previousOffset4D += translation4D;
+
+    UpdateVertices();
 }
 
 void Model4D::InitBuffers() {
+    PROFILE_SCOPE(ProfileStage::Upload);
 
+    //  GPU-       
+    if (sliceBackend == SliceBackend::Compute) {
+        if (computeVAO == 0) {
+            InitComputeBuffers();
+        }
+        return;
+    }
+    if (sliceBackend == SliceBackend::Tetrahedral) {
+        if (tetraVAO == 0) {
+            InitTetraBuffers();
+        }
+        return;
+    }
+    if (sliceBackend == SliceBackend::Projection) {
+        InitProjectionBuffers();
+        return;
+    }
 
     //   OpenGL
     if (VAO != 0) {
@@ -372,6 +1008,13 @@ void Model4D::InitBuffers() {
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
 
+    //     ;  VAO  EBO ,    
+    if (edgesEBO == 0) {
+        glGenBuffers(1, &edgesEBO);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, edgesEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, edges3D.size() * sizeof(edges3D[0]), edges3D.data(), GL_STATIC_DRAW);
+
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
 
@@ -383,8 +1026,6 @@ void Model4D::InitBuffers() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
     glEnableVertexAttribArray(1);
 
-    //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
@@ -399,4 +1040,341 @@ void Model4D::InitBuffers() {
 
     for (auto& index : indices)
         std::cout << index << " ";*/
+}
+
+void Model4D::SetSliceBackend(SliceBackend backend) {
+    if (sliceBackend == backend) return;
+    SliceBackend previous = sliceBackend;
+    sliceBackend = backend;
+
+    if (previous == SliceBackend::Projection) {
+        UpdateVertices(); //     CPU  
+    }
+    else if (sliceBackend == SliceBackend::CPU) {
+        GenerateSlice(wSlice);
+    }
+    else if (sliceBackend != SliceBackend::Projection) {
+        UpdateGPUSliceBounds();
+    }
+}
+
+void Model4D::UpdateGPUSliceBounds() {
+    //    4D- ;     ,  
+    const AABB4D& bounds = GetBounds4D();
+    gpuSliceVisible = wSlice >= bounds.min.w && wSlice <= bounds.max.w;
+    boundsMin = glm::vec3(bounds.min);
+    boundsMax = glm::vec3(bounds.max);
+}
+
+bool Model4D::GetLocalBounds(glm::vec3& min, glm::vec3& max) const {
+    if (sliceBackend == SliceBackend::CPU) {
+        return Model::GetLocalBounds(min, max);
+    }
+    if (sliceBackend == SliceBackend::Projection) {
+        GetProjectionBounds(min, max);
+        return true;
+    }
+    min = boundsMin;
+    max = boundsMax;
+    return gpuSliceVisible;
+}
+
+void Model4D::GetProjectionBounds(glm::vec3& min, glm::vec3& max) const {
+    //    4D-  restRadius;       ,
+    //       (   ,   )
+    glm::vec3 extent = glm::vec3(restRadius);
+    if (projectionMode == ProjectionMode::Perspective) {
+        extent *= projectionEyeDistance / std::max(projectionEyeDistance - restRadius, 1e-3f);
+    }
+    else if (projectionMode == ProjectionMode::Stereographic) {
+        extent *= 1e3f;
+    }
+    glm::vec3 eye = glm::vec3(GetProjectionEye());
+    min = eye - extent;
+    max = eye + extent;
+}
+
+void Model4D::InitComputeBuffers() {
+    //           ,   CPU-
+    GLuint maxVertices = 0;
+    for (size_t c = 0; c < GetCellCount(); ++c) {
+        GLuint count = cellRidgeOffsets[c + 1] - cellRidgeOffsets[c];
+        if (count >= 3) {
+            maxVertices += 3 * (count - 2); //   
+        }
+    }
+
+    // и        
+    static_assert(sizeof(edges[0]) == 2 * sizeof(GLuint));
+
+    glGenBuffers(1, &restVerticesSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, restVerticesSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, restVertices.size() * sizeof(glm::vec4), restVertices.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &edgesSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, edgesSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, edges.size() * sizeof(edges[0]), edges.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &edgePointsSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, edgePointsSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, edges.size() * sizeof(glm::vec4), nullptr, GL_DYNAMIC_COPY);
+
+    glGenBuffers(1, &cellRidgeOffsetsSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cellRidgeOffsetsSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, cellRidgeOffsets.size() * sizeof(GLuint), cellRidgeOffsets.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &cellRidgesSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cellRidgesSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(1, cellRidgeList.size()) * sizeof(GLuint), cellRidgeList.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &ridgeEdgeOffsetsSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ridgeEdgeOffsetsSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, ridgeEdgeOffsets.size() * sizeof(GLuint), ridgeEdgeOffsets.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &ridgeEdgesSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ridgeEdgesSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(1, ridgeEdgeList.size()) * sizeof(GLuint), ridgeEdgeList.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    //   : count     
+    GLuint command[4] = { 0, 1, 0, 0 };
+    glGenBuffers(1, &computeIndirectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, computeIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(command), command, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    //   [x, y, z, nx, ny, nz]      
+    computeMaxVertices = maxVertices;
+    glGenVertexArrays(1, &computeVAO);
+    glGenBuffers(1, &computeVBO);
+    glBindVertexArray(computeVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, computeVBO);
+    glBufferData(GL_ARRAY_BUFFER, std::max<GLuint>(1, maxVertices) * 6 * sizeof(GLfloat), nullptr, GL_DYNAMIC_COPY);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Model4D::ReleaseGPUBuffers() {
+    //      GL,     
+    GLuint buffers[] = {
+        VBO, EBO, edgesEBO,
+        restVerticesSSBO, edgesSSBO, edgePointsSSBO, computeVBO, computeIndirectBuffer,
+        cellRidgeOffsetsSSBO, cellRidgesSSBO, ridgeEdgeOffsetsSSBO, ridgeEdgesSSBO,
+        tetraVBO, tetraEBO,
+        projectionVBO, projectionEBO
+    };
+    GLuint arrays[] = { VAO, computeVAO, tetraVAO, projectionVAO };
+    for (GLuint buffer : buffers) {
+        if (buffer != 0) glDeleteBuffers(1, &buffer);
+    }
+    for (GLuint array : arrays) {
+        if (array != 0) glDeleteVertexArrays(1, &array);
+    }
+
+    VAO = VBO = EBO = edgesEBO = 0;
+    restVerticesSSBO = edgesSSBO = edgePointsSSBO = 0;
+    cellRidgeOffsetsSSBO = cellRidgesSSBO = ridgeEdgeOffsetsSSBO = ridgeEdgesSSBO = 0;
+    computeVAO = computeVBO = computeIndirectBuffer = 0;
+    computeMaxVertices = 0;
+    tetraVAO = tetraVBO = tetraEBO = 0;
+    projectionVAO = projectionVBO = projectionEBO = 0;
+}
+
+void Model4D::DispatchComputeSlice(GLuint edgeProgram, GLuint cellProgram) const {
+    PROFILE_SCOPE(ProfileStage::Slice);
+    if (computeVAO == 0) return;
+
+    GLuint command[4] = { 0, 1, 0, 0 };
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, computeIndirectBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), command);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, restVerticesSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, edgesSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, edgePointsSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, cellRidgeOffsetsSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, cellRidgesSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, computeVBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, computeIndirectBuffer);
+
+    //  1:     
+    glUseProgram(edgeProgram);
+    glUniformMatrix4fv(glGetUniformLocation(edgeProgram, "transform4D"), 1, GL_FALSE, &transform4D[0][0]);
+    glUniform4fv(glGetUniformLocation(edgeProgram, "offset4D"), 1, &offset4D[0]);
+    glUniform1f(glGetUniformLocation(edgeProgram, "wSlice"), wSlice);
+    glUniform1ui(glGetUniformLocation(edgeProgram, "edgeCount"), (GLuint)edges.size());
+    glDispatchCompute(((GLuint)edges.size() + 63) / 64, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    //  2:        .
+    //    ,        1
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ridgeEdgeOffsetsSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ridgeEdgesSSBO);
+    glUseProgram(cellProgram);
+    glUniform1ui(glGetUniformLocation(cellProgram, "cellCount"), (GLuint)GetCellCount());
+    glUniform1ui(glGetUniformLocation(cellProgram, "maxVertices"), computeMaxVertices);
+    glDispatchCompute(((GLuint)GetCellCount() + 63) / 64, 1, 1);
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void Model4D::DrawComputeSlice() const {
+    glBindVertexArray(computeVAO);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, computeIndirectBuffer);
+    glDrawArraysIndirect(GL_TRIANGLES, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Model4D::ReadComputeSlice(std::vector<GLfloat>& out) const {
+    //       CPU-
+    GLuint command[4] = { 0, 0, 0, 0 };
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, computeIndirectBuffer);
+    glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), command);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    out.resize(command[0] * 6);
+    glBindBuffer(GL_ARRAY_BUFFER, computeVBO);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, out.size() * sizeof(GLfloat), out.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool Model4D::CompareComputeSlice(GLuint edgeProgram, GLuint cellProgram) {
+    if (computeVAO == 0) {
+        InitComputeBuffers();
+    }
+    DispatchComputeSlice(edgeProgram, cellProgram);
+    std::vector<GLfloat> gpuVertices;
+    ReadComputeSlice(gpuVertices);
+    GenerateSlice(wSlice);
+
+    //           ,      .
+    //       ,     
+    using Triangle = std::array<uint32_t, 9>;
+    std::vector<Triangle> gpuTriangles(gpuVertices.size() / 18), cpuTriangles(indices.size() / 3);
+    for (size_t t = 0; t < gpuTriangles.size(); ++t) {
+        for (size_t k = 0; k < 3; ++k) {
+            std::memcpy(&gpuTriangles[t][k * 3], &gpuVertices[(t * 3 + k) * 6], 3 * sizeof(uint32_t));
+        }
+    }
+    for (size_t t = 0; t < cpuTriangles.size(); ++t) {
+        for (size_t k = 0; k < 3; ++k) {
+            std::memcpy(&cpuTriangles[t][k * 3], &vertices[indices[t * 3 + k] * 6], 3 * sizeof(uint32_t));
+        }
+    }
+    std::sort(gpuTriangles.begin(), gpuTriangles.end());
+    std::sort(cpuTriangles.begin(), cpuTriangles.end());
+
+    if (gpuTriangles.size() != cpuTriangles.size()) {
+        std::cerr << "GPU-: " << gpuTriangles.size() << "   " << cpuTriangles.size() << std::endl;
+        return false;
+    }
+    if (gpuTriangles != cpuTriangles) {
+        std::cerr << "GPU-:    CPU-" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Model4D::InitTetraBuffers() {
+    //       ;   wSlice  uniform'
+    glGenVertexArrays(1, &tetraVAO);
+    glGenBuffers(1, &tetraVBO);
+    glGenBuffers(1, &tetraEBO);
+
+    glBindVertexArray(tetraVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, tetraVBO);
+    glBufferData(GL_ARRAY_BUFFER, restVertices.size() * sizeof(glm::vec4), restVertices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tetraEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, tetrahedra.size() * sizeof(GLuint), tetrahedra.data(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (GLvoid*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Model4D::SetSliceUniforms(GLuint program) const {
+    glUniformMatrix4fv(glGetUniformLocation(program, "transform4D"), 1, GL_FALSE, &transform4D[0][0]);
+    glUniform4fv(glGetUniformLocation(program, "offset4D"), 1, &offset4D[0]);
+    glUniform1f(glGetUniformLocation(program, "wSlice"), wSlice);
+    glUniform3fv(glGetUniformLocation(program, "sliceCenter"), 1, &offset4D[0]); //     
+}
+
+void Model4D::DrawSliceEdges() const {
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, edgesEBO);
+    glDrawElements(GL_LINES, (GLsizei)(edges3D.size() * 2), GL_UNSIGNED_INT, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO); //  VAO  
+    glBindVertexArray(0);
+}
+
+glm::vec4 Model4D::GetProjectionEye() const {
+    //      ,       
+    glm::vec4 axisW = glm::vec4(projectionCamera4D[0][3], projectionCamera4D[1][3], projectionCamera4D[2][3], projectionCamera4D[3][3]);
+    return offset4D + axisW * projectionEyeDistance;
+}
+
+void Model4D::InitProjectionBuffers() {
+    if (projectionVAO != 0) return;
+
+    //       ;     uniform'
+    glGenVertexArrays(1, &projectionVAO);
+    glGenBuffers(1, &projectionVBO);
+    glGenBuffers(1, &projectionEBO);
+
+    glBindVertexArray(projectionVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, projectionVBO);
+    glBufferData(GL_ARRAY_BUFFER, restVertices.size() * sizeof(glm::vec4), restVertices.data(), GL_STATIC_DRAW);
+
+    size_t triangleBytes = ridgeTriangles.size() * sizeof(GLuint);
+    size_t edgeBytes = edges.size() * sizeof(edges[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, projectionEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, triangleBytes + edgeBytes, nullptr, GL_STATIC_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, triangleBytes, ridgeTriangles.data());
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, triangleBytes, edgeBytes, edges.data());
+
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (GLvoid*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Model4D::SetProjectionUniforms(GLuint program) const {
+    glm::vec4 eye = GetProjectionEye();
+    glUniformMatrix4fv(glGetUniformLocation(program, "transform4D"), 1, GL_FALSE, &transform4D[0][0]);
+    glUniform4fv(glGetUniformLocation(program, "offset4D"), 1, &offset4D[0]);
+    glUniformMatrix4fv(glGetUniformLocation(program, "camera4D"), 1, GL_FALSE, &projectionCamera4D[0][0]);
+    glUniform4fv(glGetUniformLocation(program, "eye4D"), 1, &eye[0]);
+    glUniform1f(glGetUniformLocation(program, "focalLength"), projectionEyeDistance);
+    glUniform1f(glGetUniformLocation(program, "radius4D"), restRadius);
+}
+
+void Model4D::DrawProjectedFaces() const {
+    glBindVertexArray(projectionVAO);
+    glDrawElements(GL_TRIANGLES, (GLsizei)ridgeTriangles.size(), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
+
+void Model4D::DrawProjectedEdges() const {
+    glBindVertexArray(projectionVAO);
+    glDrawElements(GL_LINES, (GLsizei)(edges.size() * 2), GL_UNSIGNED_INT, (GLvoid*)(ridgeTriangles.size() * sizeof(GLuint)));
+    glBindVertexArray(0);
+}
+
+void Model4D::DrawTetraSlice() const {
+    //       ,     
+    glBindVertexArray(tetraVAO);
+    glDrawElements(GL_LINES_ADJACENCY, (GLsizei)tetrahedra.size(), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
 }
\ No newline at end of file
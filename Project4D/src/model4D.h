@@ -2,17 +2,48 @@
 #define MODEL4D_H
 
 #include "model.h"
+#include "frameArena.h"
+#include "rotation4D.h"
 #include <glm/glm.hpp>
 #include <map>
 #include <vector>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <limits>
+#include <array>
+#include <cstdint>
+#include <span>
 
 enum class Model4DType {
     Tesseract
 };
 
+//   3D-:  CPU      ,  
+//      . Projection     
+//   4D  ; CPU    ,  
+enum class SliceBackend {
+    CPU,
+    Compute,
+    Tetrahedral,
+    Projection
+};
+
+//   4D  3D  SliceBackend::Projection  ;      
+enum class ProjectionMode {
+    Perspective,   //     w 
+    Orthographic,  //  w
+    Stereographic  //  3-      
+};
+
+//  4D-      (   shapeType  raymarching.frag)
+enum class SDF4DShape {
+    Tesseract,
+    Glome,
+    Duocylinder,
+    Spherinder
+};
+
 //  -  
 
 struct Vec3Hash {
@@ -51,36 +82,172 @@ struct pair_hash {
     }
 };
 
+//  4D-,   
+struct AABB4D {
+    glm::vec4 min = glm::vec4(std::numeric_limits<float>::max());
+    glm::vec4 max = glm::vec4(-std::numeric_limits<float>::max());
+
+    void Expand(const glm::vec4& point) { min = glm::min(min, point); max = glm::max(max, point); }
+    void Expand(const AABB4D& box) { min = glm::min(min, box.min); max = glm::max(max, box.max); }
+};
+
+//  BVH  :   left < 0,    bvhCells[first, first + count)
+struct CellBVHNode {
+    AABB4D bounds;
+    int left = -1;
+    int right = -1;
+    GLuint first = 0;
+    GLuint count = 0;
+};
+
+//    w- :     
+struct SweepInterval {
+    bool built = false;
+    std::vector<GLuint> indices;
+    std::vector<GLuint> edges; //      
+    std::vector<std::array<uint32_t, 2>> edges3D;  // и   
+    std::vector<glm::vec4> origins; // xyz   , w   w-
+    std::vector<glm::vec4> deltas;  // xyz   , w  1 / (w2 - w1)
+};
+
+// ,  GenerateSlice   :    ,    
+struct SliceState {
+    std::vector<GLfloat> vertices;
+    std::vector<GLuint> indices;
+    std::vector<GLuint> sliceEdges;
+    std::vector<std::array<uint32_t, 2>> edges3D;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+};
+
 class Model4D : public Model {
 public:
     Model4D(Model4DType type, glm::vec4 position, glm::vec4 size, glm::vec4 color, float wSlice)
         : Model(ModelType::Cube, glm::vec3(position), glm::vec3(size), glm::vec3(color)), type(type), position(position), size(size), color(color), wSlice(wSlice) {
         LoadModel4DData();
     }
+    ~Model4D();
 
 
     std::vector<glm::vec4> GetVertices() const { return defVertices; }
+    const std::vector<GLfloat>& GetSliceVertices() const { return vertices; } //   3D- [x, y, z, nx, ny, nz]
+    const std::vector<std::array<uint32_t, 2>>& GetSliceEdges() const { return edges3D; } // и  ,   
     void SetWSlice(float wSlice) { this->wSlice = wSlice; }
     float GetWSlice() const { return wSlice; }
     void GenerateSlice(float wSlice);
-    void GenerateIndices();
+    void BuildSweepIndex(bool precomputeAll = true); //      
+    void GenerateSweptSlice(float wSlice); //   :      
+    void GenerateSliceIncremental(float wSlice); //     :      
+    const AABB4D& GetBounds4D(); //    4D,    
+    const glm::mat4& GetTransform4D() const { return transform4D; } //    
+    const glm::vec4& GetOffset4D() const { return offset4D; }
+    int GetSliceEvents() const { return sliceEvents; } //  ,     
     void InitBuffers() override;
     void Translate(glm::vec3 translation, glm::vec4 translation4D) override;
-    void Rotate4D(float xw, float yw, float zw, float dt);
+    void Rotate4D(float xw, float yw, float zw, float dt); //     
+    void StepRotate4D(float xw, float yw, float zw, float dt); //  :  ,  
+    void StepRotate4D(const Bivector4D& angularVelocity, float dt); //      ,   /
+    void Interpolate(float alpha); //          
+
+    void SetSliceBackend(SliceBackend backend);
+    SliceBackend GetSliceBackend() const { return sliceBackend; }
+    bool GetLocalBounds(glm::vec3& min, glm::vec3& max) const override;
+    void DispatchComputeSlice(GLuint edgeProgram, GLuint cellProgram) const; //   GPU   
+    void DrawComputeSlice() const; //    DispatchComputeSlice
+    void ReadComputeSlice(std::vector<GLfloat>& out) const; //  GPU-  
+    bool CompareComputeSlice(GLuint edgeProgram, GLuint cellProgram); // GPU-  CPU-  :   ,    
+    void SetSliceUniforms(GLuint program) const; // 4D-  wSlice   tetraSlice
+    void DrawTetraSlice() const;
+    void DrawSliceEdges() const; //  CPU-    
+
+    // 4D-  (  SliceBackend::Projection):    eyeDistance   
+    //    ,  orientation   
+    void SetProjectionCamera(const glm::mat4& orientation) { projectionCamera4D = orientation; }
+    void SetProjectionEyeDistance(float distance) { projectionEyeDistance = distance; }
+    float GetProjectionEyeDistance() const { return projectionEyeDistance; }
+    void SetProjectionMode(ProjectionMode mode) { projectionMode = mode; } //    
+    ProjectionMode GetProjectionMode() const { return projectionMode; }
+    glm::vec4 GetProjectionEye() const;
+    void SetProjectionUniforms(GLuint program) const; // ,   4D-   projection4D
+    void DrawProjectedFaces() const; //      
+    void DrawProjectedEdges() const;
+    void InitProjectionBuffers(); //    ;        
+    void GetProjectionBounds(glm::vec3& min, glm::vec3& max) const; //      
 
 private:
     Model4DType type;
 
-    std::vector<std::vector<GLuint>> edges;
-    std::vector<std::vector<GLuint>> edges3D;
+    std::vector<std::array<uint32_t, 2>> edges;
+    std::vector<std::array<uint32_t, 2>> edges3D; // и  ,    
     std::vector<glm::vec4> defVertices;
-    std::vector<std::vector<int>> faces;
+    std::vector<glm::vec4> restVertices; //    
+    glm::mat4 transform4D = glm::mat4(1.0f); //  4D-  
+    glm::vec4 offset4D = glm::vec4(0.0f);    //  4D-
+    Rotation4D stepRotation4D, previousRotation4D; //    
+    glm::vec4 stepOffset4D = glm::vec4(0.0f), previousOffset4D = glm::vec4(0.0f);
+
+    std::vector<GLuint> cellOffsets;  // 3D- ()   CSR:   c 
+    std::vector<GLuint> cellVertices; // cellVertices[cellOffsets[c], cellOffsets[c + 1])
+    std::vector<GLuint> cellEdgeOffsets; // и  c  cellEdgeList[cellEdgeOffsets[c], cellEdgeOffsets[c + 1])
+    std::vector<GLuint> cellEdgeList;    //    edges
+    std::vector<GLuint> edgeCellOffsets; //   e  edgeCellList[edgeCellOffsets[e], edgeCellOffsets[e + 1])
+    std::vector<GLuint> edgeCellList;
+    std::vector<GLuint> vertexEdgeOffsets; // и  v  vertexEdgeList[vertexEdgeOffsets[v], vertexEdgeOffsets[v + 1])
+    std::vector<GLuint> vertexEdgeList;
+    std::vector<GLuint> ridgeEdgeOffsets; //   :   r 
+    std::vector<GLuint> ridgeEdgeList;    // ridgeEdgeList[ridgeEdgeOffsets[r], ridgeEdgeOffsets[r + 1])
+    std::vector<GLuint> cellRidgeOffsets; //    c  cellRidgeList[cellRidgeOffsets[c], cellRidgeOffsets[c + 1])
+    std::vector<GLuint> cellRidgeList;
+    GLuint edgesEBO = 0; //  edges3D  GL_LINES
+
+    glm::mat4 projectionCamera4D = glm::mat4(1.0f);
+    float projectionEyeDistance = 3.0f;
+    ProjectionMode projectionMode = ProjectionMode::Perspective;
+    float restRadius = 0.0f; //       
+    std::vector<GLuint> ridgeTriangles; //    
+    GLuint projectionVAO = 0, projectionVBO = 0, projectionEBO = 0; //  ;  EBO  ,  
+
+    FrameArena sliceArena; //   GenerateSlice,     
+    std::vector<GLuint> sliceEdges; //  ,    
+    std::vector<int> edgeVertex; // :      , -1    
+    std::vector<std::array<int, 2>> ridgeSegments; //      , { -1, -1 }    
+    std::vector<GLuint> cellTriangleCounts; //     
+    std::vector<std::array<GLuint, 3>> cellTriangles; //   c   cellRidgeOffsets[c]: n     n - 2
+
+    static constexpr size_t EdgeBucketEntriesPerEdge = 8; //    w,    
+    std::vector<GLuint> edgeBucketOffsets; //       w
+    std::vector<GLuint> edgeBucketEdges;   //  ,   [min w, max w]  
+    float edgeBucketMin = 0.0f;
+    float edgeBucketScale = 0.0f;
+    bool edgeIndexValid = false;
+    bool poseChanged = true; //       :   w  
+
+    AABB4D bounds4D;
+    bool bounds4DValid = false;
+    std::vector<CellBVHNode> cellBVH;
+    std::vector<AABB4D> cellBounds;
+    std::vector<GLuint> bvhCells;     //      BVH
+    std::vector<GLuint> touchedCells; // ,     
+    bool cellBVHValid = false;
+
+    SliceBackend sliceBackend = SliceBackend::CPU;
+    bool gpuSliceVisible = false;
+    GLuint restVerticesSSBO = 0, edgesSSBO = 0, edgePointsSSBO = 0;
+    GLuint cellRidgeOffsetsSSBO = 0, cellRidgesSSBO = 0, ridgeEdgeOffsetsSSBO = 0, ridgeEdgesSSBO = 0;
+    GLuint computeVAO = 0, computeVBO = 0, computeIndirectBuffer = 0;
+    GLuint computeMaxVertices = 0;
+    std::vector<GLuint> tetrahedra; //        
+    GLuint tetraVAO = 0, tetraVBO = 0, tetraEBO = 0;
 
-    std::vector<std::vector<GLuint>> cells; //  3D- (),      
-    std::map<std::pair<GLuint, GLuint>, std::set<std::pair<GLuint, GLuint>>> adjacentEdges;
+    std::vector<float> sweepBreakpoints; //  w- 
+    std::vector<SweepInterval> sweepIntervals;
+    bool sweepValid = false;
+    SliceState sweepScratch; //      
 
-    std::unordered_map<glm::vec3, int, Vec3Hash, Vec3Equal> intersectionMap;
-    std::unordered_map<int, std::unordered_set<int>> adjacency;
+    std::vector<unsigned char> vertexSides; //        
+    float kineticWSlice = 0.0f;
+    bool kineticValid = false;
+    int sliceEvents = 0;
 
     glm::vec4 position;
     glm::vec4 size;
@@ -88,9 +255,30 @@ private:
     float wSlice;
     
     void LoadModel4DData();
-    bool ArePointsConnectedByEdge(const glm::vec3& point1, const glm::vec3& point2);
-    std::vector<std::pair<GLuint, GLuint>> GetCellEdges(const std::vector<GLuint>& cell);
-    void ComputeAdjacentEdges();
+    void UpdateVertices(); //         
+    void UpdateGPUSliceBounds();
+    void InitComputeBuffers();
+    void ReleaseGPUBuffers(); //    VAO ,   
+    void BuildTetrahedra(); //      
+    void InitTetraBuffers();
+    size_t GetCellCount() const { return cellOffsets.empty() ? 0 : cellOffsets.size() - 1; }
+    std::span<const GLuint> GetCell(size_t cell) const { return { cellVertices.data() + cellOffsets[cell], cellOffsets[cell + 1] - cellOffsets[cell] }; }
+    void BuildCellEdges(); // и       
+    void BuildRidges();    //         
+    void UpdateRidgeSegment(GLuint ridge);
+    void BuildCellFan(GLuint cell); //       
+    void GenerateEdges3D();  // и    
+    void GenerateIndices();  //      
+    void PatchSlice(const GLuint* crossedVertices, size_t count); //      
+    void BuildSweepInterval(size_t interval); //    
+    void SwapSliceState(SliceState& state);
+    void InvalidateSliceIndices();
+    void BuildEdgeIndex();
+    void FindEdgeBucket(float wSlice, size_t& begin, size_t& end) const;
+    int UpdateVertexSides(float wSlice, GLuint* crossedVertices); //  ,  ,   
+    void BuildCellBVH();
+    int BuildCellBVHNode(GLuint first, GLuint count);
+    void QueryCellBVH(float wSlice, std::vector<GLuint>& result);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,324 @@
+#ifndef POLYTOPE_H
+#define POLYTOPE_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "model.h"
+
+//    ,   
+struct Tesseract {};
+struct Cell24 {};
+
+//  : V , E , C   K , R    S , CR   
+template <size_t V, size_t E, size_t C, size_t K, size_t R, size_t S, size_t CR>
+struct PolytopeTopology {
+    std::array<std::array<float, 4>, V> vertices{};
+    std::array<std::array<uint32_t, 2>, E> edges{};
+    std::array<std::array<uint32_t, K>, C> cells{};
+    std::array<std::array<uint32_t, S>, R> ridgeEdges{}; //    
+    std::array<std::array<uint32_t, CR>, C> cellRidges{}; //    
+
+    //      :  static_assert  
+    size_t edgeCount = 0;
+    size_t cellVertexCount = 0;
+    size_t ridgeCount = 0;
+    size_t ridgeEdgeCount = 0;
+    size_t cellRidgeCount = 0;
+};
+
+//       :
+//       edgeLengthSquared,         ,
+//       ,    
+template <size_t V, size_t E, size_t C, size_t K, size_t R, size_t S, size_t CR>
+constexpr PolytopeTopology<V, E, C, K, R, S, CR> BuildPolytopeTopology(const std::array<std::array<float, 4>, V>& vertices,
+                                                                       const std::array<std::array<float, 4>, C>& cellCenters,
+                                                                       float edgeLengthSquared) {
+    PolytopeTopology<V, E, C, K, R, S, CR> topology;
+    topology.vertices = vertices;
+
+    auto dot = [](const std::array<float, 4>& a, const std::array<float, 4>& b) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    };
+
+    for (uint32_t i = 0; i < V; ++i) {
+        for (uint32_t j = i + 1; j < V; ++j) {
+            std::array<float, 4> d = { vertices[i][0] - vertices[j][0], vertices[i][1] - vertices[j][1],
+                                       vertices[i][2] - vertices[j][2], vertices[i][3] - vertices[j][3] };
+            if (dot(d, d) == edgeLengthSquared) {
+                topology.edges[topology.edgeCount++] = { i, j };
+            }
+        }
+    }
+
+    for (size_t c = 0; c < C; ++c) {
+        float best = dot(vertices[0], cellCenters[c]);
+        for (uint32_t i = 1; i < V; ++i) {
+            float d = dot(vertices[i], cellCenters[c]);
+            best = d > best ? d : best;
+        }
+        size_t count = 0;
+        for (uint32_t i = 0; i < V; ++i) {
+            if (dot(vertices[i], cellCenters[c]) == best) {
+                topology.cells[c][count++] = i;
+            }
+        }
+        topology.cellVertexCount += count;
+    }
+
+    std::array<size_t, C> ridgesPerCell{};
+    for (uint32_t a = 0; a < C; ++a) {
+        for (uint32_t b = a + 1; b < C; ++b) {
+            std::array<uint32_t, K> shared{};
+            size_t sharedCount = 0;
+            for (uint32_t u : topology.cells[a]) {
+                for (uint32_t v : topology.cells[b]) {
+                    if (u == v) {
+                        shared[sharedCount++] = u;
+                    }
+                }
+            }
+            if (sharedCount < 3) {
+                continue;
+            }
+
+            uint32_t ridge = (uint32_t)topology.ridgeCount++;
+            size_t sideCount = 0;
+            for (uint32_t e = 0; e < E; ++e) {
+                bool first = false, second = false;
+                for (size_t i = 0; i < sharedCount; ++i) {
+                    first = first || shared[i] == topology.edges[e][0];
+                    second = second || shared[i] == topology.edges[e][1];
+                }
+                if (first && second) {
+                    topology.ridgeEdges[ridge][sideCount++] = e;
+                }
+            }
+            topology.ridgeEdgeCount += sideCount;
+            topology.cellRidges[a][ridgesPerCell[a]++] = ridge;
+            topology.cellRidges[b][ridgesPerCell[b]++] = ridge;
+        }
+    }
+    for (size_t count : ridgesPerCell) {
+        topology.cellRidgeCount += count;
+    }
+
+    return topology;
+}
+
+template <typename Shape>
+struct PolytopeTables;
+
+// :  (0.5, 0.5, 0.5, 0.5),   8 ,   24 
+template <>
+struct PolytopeTables<Tesseract> {
+    static constexpr std::array<std::array<float, 4>, 16> vertices = [] {
+        std::array<std::array<float, 4>, 16> result{};
+        for (size_t i = 0; i < 16; ++i) {
+            for (size_t axis = 0; axis < 4; ++axis) {
+                result[i][axis] = (i >> axis) & 1 ? 0.5f : -0.5f;
+            }
+        }
+        return result;
+    }();
+
+    static constexpr std::array<std::array<float, 4>, 8> cellCenters = [] {
+        std::array<std::array<float, 4>, 8> result{};
+        for (size_t axis = 0; axis < 4; ++axis) {
+            result[axis * 2][axis] = 1.0f;
+            result[axis * 2 + 1][axis] = -1.0f;
+        }
+        return result;
+    }();
+
+    static constexpr auto topology = BuildPolytopeTopology<16, 32, 8, 8, 24, 4, 6>(vertices, cellCenters, 1.0f);
+};
+
+// 24-:    (0.5, 0.5, 0, 0),   24 ,   96 
+template <>
+struct PolytopeTables<Cell24> {
+    static constexpr std::array<std::array<float, 4>, 24> vertices = [] {
+        std::array<std::array<float, 4>, 24> result{};
+        size_t count = 0;
+        for (size_t a = 0; a < 4; ++a) {
+            for (size_t b = a + 1; b < 4; ++b) {
+                for (size_t signs = 0; signs < 4; ++signs) {
+                    result[count][a] = signs & 1 ? 0.5f : -0.5f;
+                    result[count][b] = signs & 2 ? 0.5f : -0.5f;
+                    ++count;
+                }
+            }
+        }
+        return result;
+    }();
+
+    //      24-: (1, 0, 0, 0)  (0.5, 0.5, 0.5, 0.5)
+    static constexpr std::array<std::array<float, 4>, 24> cellCenters = [] {
+        std::array<std::array<float, 4>, 24> result{};
+        for (size_t axis = 0; axis < 4; ++axis) {
+            result[axis * 2][axis] = 1.0f;
+            result[axis * 2 + 1][axis] = -1.0f;
+        }
+        for (size_t i = 0; i < 16; ++i) {
+            for (size_t axis = 0; axis < 4; ++axis) {
+                result[8 + i][axis] = (i >> axis) & 1 ? 0.5f : -0.5f;
+            }
+        }
+        return result;
+    }();
+
+    static constexpr auto topology = BuildPolytopeTopology<24, 96, 24, 6, 96, 3, 8>(vertices, cellCenters, 0.5f);
+};
+
+//   :    -,    
+template <size_t Count, typename Body>
+inline void UnrollLoop(Body&& body) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        (body(std::integral_constant<size_t, I>{}), ...);
+    }(std::make_index_sequence<Count>{});
+}
+
+//     :     ,  
+template <typename Shape>
+class Polytope {
+public:
+    static constexpr const auto& topology = PolytopeTables<Shape>::topology;
+    static constexpr size_t VertexCount = topology.vertices.size();
+    static constexpr size_t EdgeCount = topology.edges.size();
+    static constexpr size_t CellCount = topology.cells.size();
+    static constexpr size_t RidgeCount = topology.ridgeEdges.size();
+
+    //        ,            
+    static constexpr size_t MaxSliceVertices = EdgeCount;
+    static constexpr size_t MaxSliceTriangles = 2 * RidgeCount;
+
+    static_assert(topology.edgeCount == EdgeCount, "     ");
+    static_assert(topology.cellVertexCount == CellCount * topology.cells[0].size(), "   ");
+    static_assert(topology.ridgeCount == RidgeCount, "      ");
+    static_assert(topology.ridgeEdgeCount == RidgeCount * topology.ridgeEdges[0].size(), "    ");
+    static_assert(topology.cellRidgeCount == CellCount * topology.cellRidges[0].size(), "    ");
+
+    //   vertexCount   triangleCount 
+    struct Slice {
+        std::array<glm::vec3, MaxSliceVertices> vertices;
+        std::array<std::array<GLuint, 3>, MaxSliceTriangles> triangles;
+        uint32_t vertexCount = 0;
+        uint32_t triangleCount = 0;
+    };
+
+    Polytope() { SetTransform4D(glm::mat4(1.0f), glm::vec4(0.0f)); }
+
+    void SetTransform4D(const glm::mat4& transform, const glm::vec4& offset) {
+        UnrollLoop<VertexCount>([&](auto i) {
+            const auto& v = topology.vertices[i];
+            vertices[i] = transform * glm::vec4(v[0], v[1], v[2], v[3]) + offset;
+        });
+    }
+
+    const std::array<glm::vec4, VertexCount>& GetVertices() const { return vertices; }
+
+    void GenerateSlice(float wSlice, Slice& slice) const {
+        slice.vertexCount = 0;
+        slice.triangleCount = 0;
+
+        // :       ,
+        //           
+        std::array<int, EdgeCount> edgeVertex;
+        UnrollLoop<EdgeCount>([&](auto e) {
+            const glm::vec4& v1 = vertices[topology.edges[e][0]];
+            const glm::vec4& v2 = vertices[topology.edges[e][1]];
+            if ((v1.w < wSlice) != (v2.w < wSlice)) {
+                float t = (wSlice - v1.w) / (v2.w - v1.w);
+                slice.vertices[slice.vertexCount] = glm::vec3(v1) + t * (glm::vec3(v2) - glm::vec3(v1));
+                edgeVertex[e] = (int)slice.vertexCount++;
+            }
+            else {
+                edgeVertex[e] = -1;
+            }
+        });
+
+        //      
+        std::array<std::array<int, 2>, RidgeCount> segments;
+        UnrollLoop<RidgeCount>([&](auto r) {
+            std::array<int, 2> segment = { -1, -1 };
+            UnrollLoop<topology.ridgeEdges[0].size()>([&](auto s) {
+                int v = edgeVertex[topology.ridgeEdges[r][s]];
+                if (v >= 0) {
+                    segment[segment[0] < 0 ? 0 : 1] = v;
+                }
+            });
+            segments[r] = segment;
+        });
+
+        //         :    
+        UnrollLoop<CellCount>([&](auto c) {
+            int first = -1;
+            UnrollLoop<topology.cellRidges[0].size()>([&](auto k) {
+                const std::array<int, 2>& segment = segments[topology.cellRidges[c][k]];
+                if (segment[1] < 0) {
+                    return;
+                }
+                if (first < 0) {
+                    first = segment[0];
+                }
+                else if (segment[0] != first && segment[1] != first) {
+                    slice.triangles[slice.triangleCount++] = { (GLuint)first, (GLuint)segment[0], (GLuint)segment[1] };
+                }
+            });
+        });
+    }
+
+private:
+    std::array<glm::vec4, VertexCount> vertices; //    
+};
+
+//  Model4D   :     ,   Polytope<Shape>.
+//       (--alloc-check, --polytope-check),     
+template <typename Shape>
+class PolytopeModel4D : public Model {
+public:
+    PolytopeModel4D(glm::vec4 position, glm::vec4 size, glm::vec4 color, float wSlice)
+        : Model(ModelType::Cube, glm::vec3(position), glm::vec3(size), glm::vec3(color)), wSlice(wSlice) {
+        vertices.reserve(Polytope<Shape>::MaxSliceVertices * 6);
+        indices.reserve(Polytope<Shape>::MaxSliceTriangles * 3);
+        GenerateSlice(wSlice);
+    }
+
+    void SetWSlice(float wSlice) { this->wSlice = wSlice; }
+    float GetWSlice() const { return wSlice; }
+
+    //   ,  GetTransform4D()/GetOffset4D()  Model4D
+    void SetTransform4D(const glm::mat4& transform, const glm::vec4& offset) { polytope.SetTransform4D(transform, offset); }
+
+    void GenerateSlice(float wSlice) {
+        polytope.GenerateSlice(wSlice, slice);
+
+        //  [x, y, z, nx, ny, nz]   Model4D;       
+        vertices.resize(slice.vertexCount * 6);
+        for (uint32_t i = 0; i < slice.vertexCount; ++i) {
+            const glm::vec3& p = slice.vertices[i];
+            GLfloat* out = &vertices[i * 6];
+            out[0] = p.x; out[1] = p.y; out[2] = p.z;
+            out[3] = 1.0f; out[4] = 1.0f; out[5] = 1.0f;
+        }
+        indices.resize(slice.triangleCount * 3);
+        for (uint32_t i = 0; i < slice.triangleCount; ++i) {
+            indices[i * 3] = slice.triangles[i][0];
+            indices[i * 3 + 1] = slice.triangles[i][1];
+            indices[i * 3 + 2] = slice.triangles[i][2];
+        }
+        UpdateBounds();
+    }
+
+    const Polytope<Shape>& GetPolytope() const { return polytope; }
+    const typename Polytope<Shape>::Slice& GetSlice() const { return slice; }
+
+private:
+    Polytope<Shape> polytope;
+    typename Polytope<Shape>::Slice slice;
+    float wSlice;
+};
+
+#endif
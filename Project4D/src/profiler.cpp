@@ -0,0 +1,252 @@
+#include "profiler.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+//    
+static thread_local std::chrono::steady_clock::time_point cpuStart[(int)ProfileStage::Count];
+static thread_local int cpuDepth[(int)ProfileStage::Count] = {};
+static thread_local int threadLane = -1;
+
+Profiler& Profiler::Instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+const char* Profiler::GetStageName(ProfileStage stage) {
+    switch (stage) {
+        case ProfileStage::Rotate: return "rotate";
+        case ProfileStage::Slice: return "slice";
+        case ProfileStage::Indices: return "index";
+        case ProfileStage::Upload: return "upload";
+        case ProfileStage::Draw: return "draw";
+        case ProfileStage::Post: return "post";
+        case ProfileStage::Swap: return "swap";
+        default: return "?";
+    }
+}
+
+void Profiler::History::Push(float value) {
+    values[next] = value;
+    next = (next + 1) % historySize;
+    count = std::min(count + 1, historySize);
+}
+
+ProfileStats Profiler::History::GetStats() const {
+    ProfileStats stats;
+    stats.samples = count;
+    if (count == 0) {
+        return stats;
+    }
+
+    //   :   ,      
+    float sorted[historySize];
+    std::copy(values, values + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        sum += sorted[i];
+    }
+    auto percentile = [&](float p) { return sorted[std::min((int)(p * count), count - 1)]; };
+
+    stats.average = (float)(sum / count);
+    stats.p50 = percentile(0.50f);
+    stats.p95 = percentile(0.95f);
+    stats.p99 = percentile(0.99f);
+    stats.max = sorted[count - 1];
+    return stats;
+}
+
+void Profiler::BeginCpu(ProfileStage stage) {
+    int index = (int)stage;
+    if (cpuDepth[index]++ == 0) {
+        cpuStart[index] = Clock::now();
+    }
+}
+
+void Profiler::EndCpu(ProfileStage stage) {
+    int index = (int)stage;
+    if (--cpuDepth[index] != 0) {
+        return;
+    }
+
+    Clock::time_point end = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    cpuFrame[index] += std::chrono::duration<double, std::milli>(end - cpuStart[index]).count();
+    if (traceFramesLeft > 0) {
+        double start = TraceTime(cpuStart[index]);
+        AddTraceEvent({ GetStageName(stage), 'X', GetThreadLane(), start, TraceTime(end) - start, 0.0, traceFrame });
+    }
+}
+
+int Profiler::GetThreadLane() {
+    if (threadLane < 0) {
+        threadLane = (int)threadNames.size();
+        threadNames.push_back(threadLane == 0 ? "render" : "thread " + std::to_string(threadLane));
+    }
+    return threadLane;
+}
+
+void Profiler::SetThreadName(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    threadNames[GetThreadLane()] = name;
+}
+
+void Profiler::Counter(const char* name, double value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (traceFramesLeft > 0) {
+        AddTraceEvent({ name, 'C', GetThreadLane(), TraceTime(Clock::now()), 0.0, value, traceFrame });
+    }
+}
+
+void Profiler::AddTraceEvent(const TraceEvent& event) {
+    if (traceEvents.size() < traceEvents.capacity()) {
+        traceEvents.push_back(event);
+    }
+    else {
+        ++traceDropped;
+    }
+}
+
+bool Profiler::StartTrace(const std::string& path, int frames) {
+    if (frames < 1 || frames > maxTraceFrames) {
+        std::cerr << "      1  " << maxTraceFrames << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    tracePath = path;
+    traceFramesLeft = frames;
+    traceFrame = 0;
+    traceDropped = 0;
+    traceEvents.clear();
+    traceEvents.reserve((size_t)frames * traceEventsPerFrame);
+    traceStart = Clock::now();
+    frameStart = traceStart;
+    return true;
+}
+
+void Profiler::WriteTrace() {
+    std::ofstream file(tracePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "  : " << tracePath << std::endl;
+        return;
+    }
+
+    //         ,   
+    char line[256];
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Project4D\"}}";
+    for (size_t i = 0; i < threadNames.size(); ++i) {
+        std::snprintf(line, sizeof(line), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", (int)i, threadNames[i].c_str());
+        file << line;
+    }
+    for (const TraceEvent& event : traceEvents) {
+        if (event.phase == 'X') {
+            std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%d}}",
+                event.name, event.thread, event.start, event.duration, event.frame);
+        }
+        else {
+            std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%.17g}}",
+                event.name, event.thread, event.start, event.value);
+        }
+        file << line;
+    }
+    file << "\n]}\n";
+
+    std::cout << " : " << tracePath << " (" << traceEvents.size() << " )" << std::endl;
+    if (traceDropped > 0) {
+        std::cerr << "    : " << traceDropped << " " << std::endl;
+    }
+}
+
+void Profiler::ReadGpuQuery(int frame, int stage) {
+    //  gpuFrames ,    
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(gpuQueries[frame][stage], GL_QUERY_RESULT, &elapsed);
+    gpuHistory[stage].Push((float)(elapsed / 1.0e6));
+    gpuPending[frame][stage] = false;
+}
+
+void Profiler::BeginGpu(ProfileStage stage) {
+    int index = (int)stage;
+    if (gpuQueries[gpuFrame][index] == 0) {
+        glGenQueries(1, &gpuQueries[gpuFrame][index]);
+    }
+    else if (gpuPending[gpuFrame][index]) {
+        ReadGpuQuery(gpuFrame, index);
+    }
+    glBeginQuery(GL_TIME_ELAPSED, gpuQueries[gpuFrame][index]);
+}
+
+void Profiler::EndGpu(ProfileStage stage) {
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuPending[gpuFrame][(int)stage] = true;
+}
+
+void Profiler::EndFrame() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < stageCount; ++i) {
+            cpuHistory[i].Push((float)cpuFrame[i]);
+            cpuFrame[i] = 0.0;
+        }
+
+        //      ;       
+        Clock::time_point now = Clock::now();
+        if (traceFramesLeft > 0) {
+            double start = TraceTime(frameStart);
+            AddTraceEvent({ "frame", 'X', GetThreadLane(), start, TraceTime(now) - start, 0.0, traceFrame });
+            ++traceFrame;
+            if (--traceFramesLeft == 0) {
+                WriteTrace();
+                traceEvents.clear();
+                traceEvents.shrink_to_fit();
+            }
+        }
+        frameStart = now;
+    }
+
+    //         
+    gpuFrame = (gpuFrame + 1) % gpuFrames;
+    for (int i = 0; i < stageCount; ++i) {
+        if (gpuPending[gpuFrame][i]) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(gpuQueries[gpuFrame][i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                ReadGpuQuery(gpuFrame, i);
+            }
+        }
+    }
+
+    if (logInterval > 0.0 && std::chrono::duration<double>(Clock::now() - lastLog).count() >= logInterval) {
+        lastLog = Clock::now();
+        Log();
+    }
+}
+
+ProfileStats Profiler::GetCpuStats(ProfileStage stage) const {
+    return cpuHistory[(int)stage].GetStats();
+}
+
+ProfileStats Profiler::GetGpuStats(ProfileStage stage) const {
+    return gpuHistory[(int)stage].GetStats();
+}
+
+void Profiler::Log() const {
+    //  :   p95   ,    GPU-    GPU
+    char line[1024];
+    int length = std::snprintf(line, sizeof(line), ",  (/p95):");
+    for (int i = 0; i < stageCount && length < (int)sizeof(line); ++i) {
+        ProfileStats cpu = cpuHistory[i].GetStats();
+        ProfileStats gpu = gpuHistory[i].GetStats();
+        length += std::snprintf(line + length, sizeof(line) - length, " %s %.2f/%.2f", GetStageName((ProfileStage)i), cpu.average, cpu.p95);
+        if (gpu.samples > 0 && length < (int)sizeof(line)) {
+            length += std::snprintf(line + length, sizeof(line) - length, " (gpu %.2f/%.2f)", gpu.average, gpu.p95);
+        }
+    }
+    std::cout << line << std::endl;
+}
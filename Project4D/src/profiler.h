@@ -0,0 +1,146 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <GL/glew.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//     (PROJECT4D_PROFILE=1);     
+#ifndef PROJECT4D_PROFILE
+#define PROJECT4D_PROFILE 0
+#endif
+
+//  .        :       
+enum class ProfileStage {
+    Rotate,  // 4D-
+    Slice,   //   
+    Indices, //   
+    Upload,  //  
+    Draw,    // DrawModels
+    Post,    // PostProcessing
+    Swap,    // SwapBuffers
+    Count
+};
+
+struct ProfileStats {
+    float average = 0.0f; //    
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    int samples = 0;
+};
+
+class Profiler {
+public:
+    static constexpr int historySize = 240; //    
+    static constexpr int gpuFrames = 4;     //     GPU-:    
+    static constexpr int traceEventsPerFrame = 64; //     ;      
+    static constexpr int maxTraceFrames = 10000;   //   :    
+
+    static Profiler& Instance();
+
+    void BeginCpu(ProfileStage stage);
+    void EndCpu(ProfileStage stage);
+    void BeginGpu(ProfileStage stage); // GL_TIME_ELAPSED;     GPU-
+    void EndGpu(ProfileStage stage);
+    void EndFrame(); //          
+
+    ProfileStats GetCpuStats(ProfileStage stage) const;
+    ProfileStats GetGpuStats(ProfileStage stage) const;
+    void SetLogInterval(double seconds) { logInterval = seconds; } // 0   
+    void Log() const;
+
+    static const char* GetStageName(ProfileStage stage);
+
+    //   frames    Chrome trace event (chrome://tracing, Perfetto).
+    //     ,        
+    bool StartTrace(const std::string& path, int frames); // false,  frames   [1, maxTraceFrames]
+    bool IsTracing() const { return traceFramesLeft > 0; }
+    void Counter(const char* name, double value); //      (  )
+    void SetThreadName(const char* name); //      
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int stageCount = (int)ProfileStage::Count;
+
+    struct History {
+        float values[historySize] = {};
+        int count = 0;
+        int next = 0;
+
+        void Push(float value);
+        ProfileStats GetStats() const;
+    };
+
+    //        (thread_local  profiler.cpp),    
+    double cpuFrame[stageCount] = {}; //    , 
+    std::mutex mutex;
+    History cpuHistory[stageCount];
+
+    GLuint gpuQueries[gpuFrames][stageCount] = {};
+    bool gpuPending[gpuFrames][stageCount] = {};
+    History gpuHistory[stageCount];
+    int gpuFrame = 0;
+
+    double logInterval = 5.0;
+    Clock::time_point lastLog = Clock::now();
+
+    //  : ph   (X  , C  , M   )
+    struct TraceEvent {
+        const char* name;
+        char phase;
+        int thread;
+        double start; //    
+        double duration;
+        double value;
+        int frame;
+    };
+    std::vector<TraceEvent> traceEvents;
+    std::vector<std::string> threadNames; //   
+    std::string tracePath;
+    int traceFramesLeft = 0;
+    int traceFrame = 0;
+    size_t traceDropped = 0; // ,    
+    Clock::time_point traceStart;
+    Clock::time_point frameStart = Clock::now();
+
+    Profiler() = default;
+    void ReadGpuQuery(int frame, int stage);
+    double TraceTime(Clock::time_point time) const { return std::chrono::duration<double, std::micro>(time - traceStart).count(); }
+    int GetThreadLane(); //   ,   mutex
+    void AddTraceEvent(const TraceEvent& event); //   :     ,   mutex
+    void WriteTrace();
+};
+
+//         
+class ProfileScope {
+public:
+    ProfileScope(ProfileStage stage) : stage(stage) { Profiler::Instance().BeginCpu(stage); }
+    ~ProfileScope() { Profiler::Instance().EndCpu(stage); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileStage stage;
+};
+
+#if PROJECT4D_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(stage) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(stage)
+#define PROFILE_GPU_BEGIN(stage) Profiler::Instance().BeginGpu(stage)
+#define PROFILE_GPU_END(stage) Profiler::Instance().EndGpu(stage)
+#define PROFILE_END_FRAME() Profiler::Instance().EndFrame()
+#define PROFILE_COUNTER(name, value) Profiler::Instance().Counter(name, (double)(value))
+#else
+#define PROFILE_SCOPE(stage) ((void)0)
+#define PROFILE_GPU_BEGIN(stage) ((void)0)
+#define PROFILE_GPU_END(stage) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#endif
+
+#endif
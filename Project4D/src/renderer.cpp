@@ -3,13 +3,18 @@
 #include <filesystem>
 #include <thread>
 #include "renderer.h"
+#include "embeddedShaders.h"
+#include "profiler.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+//    4D  ProjectionMode
+static const char* projectionPrograms[] = { "projection4D", "projection4D_orthographic", "projection4D_stereographic" };
+
 // :     OpenGL
-Renderer::Renderer(int width, int height, const char* title) { //  
+Renderer::Renderer(int width, int height, const char* title, const std::string& shaderDirectory) { //  
     if (!glfwInit()) {
         std::cerr << "  GLFW!" << std::endl;
         exit(EXIT_FAILURE);
@@ -47,19 +52,38 @@ Renderer::Renderer(int width, int height, const char* title) { // 
     lights.push_back(new Light(glm::vec3(1.2f, 3.0f, 2.0f), glm::vec3(1.0f, 0.0f, 1.0f)));
     lights.push_back(new Light(glm::vec3(-1.2f, 3.0f, -2.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
 
+    //    .       PROJECT4D_SHADERS
+    //        
+    if (!shaderDirectory.empty()) {
+        this->shaderDirectory = shaderDirectory;
+    }
+    else if (const char* environment = std::getenv("PROJECT4D_SHADERS")) {
+        this->shaderDirectory = environment;
+    }
+
     //    
     InitShaders();
+    if (!this->shaderDirectory.empty()) {
+        shaderWatcher.Start(this->shaderDirectory);
+    }
     InitFrameBuffers();
 }
 
 //  
 void Renderer::Clear() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    //      FBO,     PostProcessing
+    glBindFramebuffer(GL_FRAMEBUFFER, postProcessing ? fbo : 0);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
+//      
+void Renderer::SetVSync(bool enabled) {
+    glfwSwapInterval(enabled ? 1 : 0);
+}
+
 //  
 void Renderer::SwapBuffers() {
+    PROFILE_SCOPE(ProfileStage::Swap);
     glfwSwapBuffers(window);
 }
 
@@ -68,21 +92,12 @@ bool Renderer::ShouldClose() {
     return glfwWindowShouldClose(window);
 }
 
-void Renderer::Time() {
-	currentTime = glfwGetTime();
-	deltaTime = currentTime - lastTime;
-	lastTime = currentTime;
-}
-
 //  
-void Renderer::PollEvents() {
+void Renderer::PollEvents(float deltaTime) {
     glfwPollEvents();
-    float currentFrame = glfwGetTime();
-    static float lastFrame = 0.0f;
-    deltaTime = currentFrame - lastFrame;
-    lastFrame = currentFrame;
     ProcessInput(window, deltaTime);
     camera->ProcessCursor(window); //     
+    ReloadChangedShaders();
 }
 
 // :  
@@ -103,18 +118,29 @@ Renderer::~Renderer() {
     glfwTerminate();
 }
 
-std::string ReadFile(const char* filePath) {
+//     :        
+static bool TryReadFile(const char* filePath, std::string& content) {
     std::filesystem::path path = std::filesystem::current_path() / filePath;
     path = path.lexically_normal();
     std::ifstream file(path);
     if (!file.is_open()) {
         std::cerr << "  : " << path << std::endl;
-        exit(EXIT_FAILURE);
+        return false;
     }
 
     std::stringstream buffer;
     buffer << file.rdbuf();
-    return buffer.str();
+    content = buffer.str();
+    return true;
+}
+
+//   :    
+std::string ReadFile(const char* filePath) {
+    std::string content;
+    if (!TryReadFile(filePath, content)) {
+        exit(EXIT_FAILURE);
+    }
+    return content;
 }
 
 //  
@@ -128,8 +154,8 @@ void Renderer::InitFrameBuffers() {
     //  FBO
     if (fbo == 0) {
         glGenFramebuffers(1, &fbo);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     }
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 
     //    
     glGenTextures(1, &colorBufferTexture);
@@ -143,6 +169,8 @@ void Renderer::InitFrameBuffers() {
     glGenTextures(1, &depthBufferTexture);
     glBindTexture(GL_TEXTURE_2D, depthBufferTexture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, screenWidth, screenHeight, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); //  -   
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthBufferTexture, 0);
 
     //   
@@ -151,29 +179,255 @@ void Renderer::InitFrameBuffers() {
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0); //    
+
+    InitTraceBuffers();
+}
+
+void Renderer::InitTraceBuffers() {
+    if (raymarchDivisor == 1) {
+        return;
+    }
+
+    traceWidth = std::max((int)screenWidth / raymarchDivisor, 1);
+    traceHeight = std::max((int)screenHeight / raymarchDivisor, 1);
+
+    if (traceFBO == 0) {
+        glGenFramebuffers(1, &traceFBO);
+        glGenTextures(1, &traceTexture);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, traceFBO);
+
+    //     :    
+    glBindTexture(GL_TEXTURE_2D, traceTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, traceWidth, traceHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, traceTexture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << ": Framebuffer   !" << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-//  
+//  .      ,
+//    FinishProgram,      
 GLuint Renderer::CompileShader(GLenum shaderType, const std::string& shaderSource) {
     GLuint shader = glCreateShader(shaderType);
     const char* shaderCode = shaderSource.c_str();
     glShaderSource(shader, 1, &shaderCode, nullptr);
     glCompileShader(shader);
-    CheckShaderCompileError(shader, shaderType == GL_VERTEX_SHADER ? "" : "");
     return shader;
 }
 
-GLuint Renderer::CreateProgram(GLuint vertexShader, GLuint fragmentShader) {
+GLuint Renderer::CreateProgram(const std::vector<GLuint>& shaders) {
     GLuint program = glCreateProgram();
-    if (vertexShader != 0) {
-        glAttachShader(program, vertexShader);
+    for (GLuint shader : shaders) {
+        glAttachShader(program, shader);
     }
-    glAttachShader(program, fragmentShader);
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE); //    
     glLinkProgram(program);
-    CheckProgramLinkError(program);
     return program;
 }
 
+void Renderer::SubmitProgram(const std::string& name, const std::string& source, const std::vector<std::pair<GLenum, const std::string*>>& stages) {
+    //        
+    GLuint program = shaderCache.LoadProgram(name, source);
+    if (program != 0) {
+        shaderPrograms[name] = program;
+        return;
+    }
+
+    PendingProgram pending;
+    pending.name = name;
+    pending.source = source;
+    for (const auto& stage : stages) {
+        pending.shaders.push_back(CompileShader(stage.first, *stage.second));
+    }
+    pending.program = CreateProgram(pending.shaders);
+    shaderPrograms[name] = pending.program;
+    pendingPrograms.push_back(std::move(pending));
+}
+
+bool Renderer::FinishProgram(const PendingProgram& pending) {
+    bool success = true;
+    for (GLuint shader : pending.shaders) {
+        GLint shaderType = 0;
+        glGetShaderiv(shader, GL_SHADER_TYPE, &shaderType);
+        success &= CheckShaderCompileError(shader, shaderType == GL_VERTEX_SHADER ? "" : shaderType == GL_COMPUTE_SHADER ? "" : shaderType == GL_GEOMETRY_SHADER ? "" : "");
+    }
+    success &= CheckProgramLinkError(pending.program);
+    if (success) {
+        shaderCache.StoreProgram(pending.name, pending.source, pending.program);
+    }
+
+    //      
+    for (GLuint shader : pending.shaders) {
+        glDeleteShader(shader);
+    }
+    return success;
+}
+
+//     ; false,       
+static bool FindEmbeddedShader(const std::string& file, std::string& source) {
+    for (const auto& shader : embeddedShaders) {
+        if (shader.file == file) {
+            source.assign(shader.source);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Renderer::ReadShaderSource(const std::string& file, std::string& source, bool& readFailed) {
+    //      
+    if (!shaderDirectory.empty()) {
+        std::filesystem::path path = std::filesystem::path(shaderDirectory) / file;
+        std::error_code error;
+        if (std::filesystem::exists(path, error)) {
+            readFailed = !TryReadFile(path.string().c_str(), source);
+            return !readFailed;
+        }
+    }
+    return FindEmbeddedShader(file, source);
+}
+
+//  :      #define   #version
+struct ShaderVariant {
+    const char* name;
+    const char* base;
+    const char* define;
+};
+
+static const ShaderVariant shaderVariants[] = {
+    { "projection4D_orthographic", "projection4D", "PROJECTION_ORTHOGRAPHIC" },
+    { "projection4D_stereographic", "projection4D", "PROJECTION_STEREOGRAPHIC" }
+};
+
+static std::string AddDefine(const std::string& source, const char* define) {
+    size_t line = source.find('\n');
+    size_t position = line == std::string::npos ? source.size() : line + 1;
+    return source.substr(0, position) + "#define " + define + "\n" + source.substr(position);
+}
+
+bool Renderer::ReadProgramStages(const std::string& name, std::vector<std::pair<GLenum, std::string>>& stages, std::string& source) {
+    for (const auto& variant : shaderVariants) {
+        if (name == variant.name) {
+            if (!ReadProgramStages(variant.base, stages, source)) {
+                return false;
+            }
+            for (auto& stage : stages) {
+                stage.second = AddDefine(stage.second, variant.define);
+            }
+            source = std::string("define ") + variant.define + "\n" + source;
+            return true;
+        }
+    }
+
+    //       ,   InitShaders
+    static const std::pair<GLenum, const char*> extensions[] = {
+        { GL_VERTEX_SHADER, "vert" }, { GL_GEOMETRY_SHADER, "geom" }, { GL_FRAGMENT_SHADER, "frag" }, { GL_COMPUTE_SHADER, "comp" }
+    };
+
+    bool hasVertex = false;
+    for (const auto& extension : extensions) {
+        std::string stageSource;
+        bool readFailed = false;
+        bool exists = ReadShaderSource(name + "." + extension.second, stageSource, readFailed);
+        if (readFailed) {
+            return false;
+        }
+        hasVertex |= exists && extension.first == GL_VERTEX_SHADER;
+        if (exists || (hasVertex && extension.first == GL_GEOMETRY_SHADER)) {
+            source += std::string(extension.second) + "\n" + stageSource;
+        }
+        if (exists) {
+            stages.push_back({ extension.first, std::move(stageSource) });
+        }
+    }
+    return true;
+}
+
+bool Renderer::ReloadProgram(const std::string& name) {
+    std::vector<std::pair<GLenum, std::string>> stages;
+    std::string source;
+    if (!ReadProgramStages(name, stages, source)) {
+        std::cerr << " " << name << "  ,   " << std::endl;
+        return false;
+    }
+    if (stages.empty()) {
+        return false;
+    }
+
+    //  :       
+    PendingProgram pending;
+    pending.name = name;
+    pending.source = source;
+    for (const auto& stage : stages) {
+        pending.shaders.push_back(CompileShader(stage.first, stage.second));
+    }
+    pending.program = CreateProgram(pending.shaders);
+
+    if (!FinishProgram(pending)) {
+        std::cerr << " " << name << "  ,   " << std::endl;
+        glDeleteProgram(pending.program);
+        return false;
+    }
+
+    //   :    DrawModels    
+    auto it = shaderPrograms.find(name);
+    GLuint oldProgram = it != shaderPrograms.end() ? it->second : 0;
+    shaderPrograms[name] = pending.program;
+    if (oldProgram != 0) {
+        glDeleteProgram(oldProgram);
+    }
+    std::cout << " " << name << " " << std::endl;
+    return true;
+}
+
+void Renderer::ReloadChangedShaders() {
+    //    ,   
+    if (shaderDirectory.empty()) {
+        return;
+    }
+
+    for (const std::string& name : shaderWatcher.PollChanged()) {
+        ReloadProgram(name);
+        for (const auto& variant : shaderVariants) {
+            if (name == variant.base) {
+                ReloadProgram(variant.name);
+            }
+        }
+    }
+}
+
+bool Renderer::PollShaders() {
+    //       ,     
+    for (size_t i = 0; i < pendingPrograms.size();) {
+        if (parallelCompile) {
+            GLint complete = GL_FALSE;
+            glGetProgramiv(pendingPrograms[i].program, GL_COMPLETION_STATUS_KHR, &complete);
+            if (!complete) {
+                ++i;
+                continue;
+            }
+        }
+        FinishProgram(pendingPrograms[i]);
+        pendingPrograms[i] = std::move(pendingPrograms.back());
+        pendingPrograms.pop_back();
+    }
+    return pendingPrograms.empty();
+}
+
+void Renderer::FinishShaders() {
+    while (!PollShaders()) {
+        std::this_thread::yield();
+    }
+}
+
 std::vector<std::string> Renderer::GetShaderFiles(const std::string& directory) {
     std::vector<std::string> shaderFiles;
     for (const auto& entry : std::filesystem::directory_iterator(directory)) {
@@ -182,7 +436,7 @@ std::vector<std::string> Renderer::GetShaderFiles(const std::string& directory)
     return shaderFiles;
 }
 
-void Renderer::CheckShaderCompileError(GLuint shader, const std::string& shaderType) {
+bool Renderer::CheckShaderCompileError(GLuint shader, const std::string& shaderType) {
     GLint success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
@@ -190,9 +444,10 @@ void Renderer::CheckShaderCompileError(GLuint shader, const std::string& shaderT
         glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
         std::cerr << "  " << shaderType << " : " << infoLog << std::endl;
     }
+    return success;
 }
 
-void Renderer::CheckProgramLinkError(GLuint program) {
+bool Renderer::CheckProgramLinkError(GLuint program) {
     GLint success;
     glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
@@ -200,73 +455,155 @@ void Renderer::CheckProgramLinkError(GLuint program) {
         glGetProgramInfoLog(program, sizeof(infoLog), nullptr, infoLog);
         std::cerr << "   : " << infoLog << std::endl;
     }
+    return success;
 }
 
 void Renderer::InitShaders() {
-    //     
-    std::vector<std::string> shaderFiles = GetShaderFiles("..\\..\\..\\..\\Project4D\\src\\shaders\\");
+    shaderCache.Init();
+
+    //      ,    
+    parallelCompile = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF); //    
+    }
+    else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
 
     std::unordered_map<std::string, std::string> vertexShaders;
     std::unordered_map<std::string, std::string> fragmentShaders;
+    std::unordered_map<std::string, std::string> geometryShaders;
+    std::unordered_map<std::string, std::string> computeShaders;
 
-    //       vertex  fragment
-    for (const auto& file : shaderFiles) {
-        std::string extension = file.substr(file.find_last_of(".") + 1);
-        std::string name = file.substr(file.find_last_of("\\") + 1, file.find_last_of(".") - file.find_last_of("\\") - 1);
+    //    vertex, fragment, geometry  compute   
+    auto addShader = [&](const std::filesystem::path& file, std::string source) {
+        std::string extension = file.extension().string();
+        std::string name = file.stem().string();
 
-        if (extension == "vert") {
-            vertexShaders[name] = ReadFile(file.c_str());
+        if (extension == ".vert") {
+            vertexShaders[name] = std::move(source);
+        }
+        else if (extension == ".frag") {
+            fragmentShaders[name] = std::move(source);
         }
-        else if (extension == "frag") {
-            fragmentShaders[name] = ReadFile(file.c_str());
+        else if (extension == ".geom") {
+            geometryShaders[name] = std::move(source);
+        }
+        else if (extension == ".comp") {
+            computeShaders[name] = std::move(source);
+        }
+    };
+
+    //    ,       
+    for (const auto& shader : embeddedShaders) {
+        addShader(std::filesystem::path(shader.file), std::string(shader.source));
+    }
+    if (!shaderDirectory.empty()) {
+        for (const auto& file : GetShaderFiles(shaderDirectory)) {
+            addShader(std::filesystem::path(file), ReadFile(file.c_str()));
         }
     }
 
-    //   :   vert/frag   
+    //   :   vert/frag   ,
+    //         
     for (const auto& vertPair : vertexShaders) {
         const std::string& shaderName = vertPair.first;
 
         if (fragmentShaders.find(shaderName) != fragmentShaders.end()) {
-            //        
-            GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexShaders[shaderName]);
-            GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentShaders[shaderName]);
-
-            //     
-            GLuint program = CreateProgram(vertexShader, fragmentShader);
-            shaderPrograms[shaderName] = program;
-
-            //      
-            glDeleteShader(vertexShader);
-            glDeleteShader(fragmentShader);
+            std::vector<std::pair<GLenum, const std::string*>> stages = { { GL_VERTEX_SHADER, &vertPair.second } };
+            std::string source = "vert\n" + vertPair.second + "geom\n";
+            if (geometryShaders.find(shaderName) != geometryShaders.end()) {
+                stages.push_back({ GL_GEOMETRY_SHADER, &geometryShaders[shaderName] });
+                source += geometryShaders[shaderName];
+            }
+            stages.push_back({ GL_FRAGMENT_SHADER, &fragmentShaders[shaderName] });
+            source += "frag\n" + fragmentShaders[shaderName];
+
+            SubmitProgram(shaderName, source, stages);
         }
     }
 
     //       
     for (const auto& fragPair : fragmentShaders) {
-        const std::string& shaderName = fragPair.first;
+        if (shaderPrograms.find(fragPair.first) == shaderPrograms.end()) {
+            SubmitProgram(fragPair.first, "frag\n" + fragPair.second, { { GL_FRAGMENT_SHADER, &fragPair.second } });
+        }
+    }
 
-        if (shaderPrograms.find(shaderName) == shaderPrograms.end()) {
-            //   ,      
-            GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragPair.second);
+    //      
+    for (const auto& compPair : computeShaders) {
+        SubmitProgram(compPair.first, "comp\n" + compPair.second, { { GL_COMPUTE_SHADER, &compPair.second } });
+    }
 
-            //      
-            GLuint program = CreateProgram(0, fragmentShader);
-            shaderPrograms[shaderName] = program;
+    //   #define:      ,   
+    for (const auto& variant : shaderVariants) {
+        std::vector<std::pair<GLenum, std::string>> stages;
+        std::string source;
+        if (!ReadProgramStages(variant.name, stages, source) || stages.empty()) continue;
 
-            //   
-            glDeleteShader(fragmentShader);
+        std::vector<std::pair<GLenum, const std::string*>> stagePointers;
+        for (const auto& stage : stages) {
+            stagePointers.push_back({ stage.first, &stage.second });
         }
+        SubmitProgram(variant.name, source, stagePointers);
     }
 }
 
 //   
 void Renderer::DrawModels() {
+    FinishShaders(); //     : main     
+
+    PROFILE_SCOPE(ProfileStage::Draw);
+    PROFILE_GPU_BEGIN(ProfileStage::Draw);
+
 	shaderProgram = shaderPrograms["mainShader"];
     glUseProgram(shaderProgram);
 
+    //       
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)800 / (float)600, 0.1f, 100.0f);
+    frustum.Update(projection * camera->GetViewMatrix());
+
+    drawnModels = 0;
+    culledModels = 0;
+
     for (const auto& model : models) {
-        DrawModel(model);
+        //  4D-  PostProcessing,        
+        if (postProcessing && model == raymarchTarget) {
+            continue;
+        }
+
+        //   4D-   ,   
+        Model4D* model4D = skeleton ? dynamic_cast<Model4D*>(model) : nullptr;
+        if (model4D && model4D->GetSliceBackend() == SliceBackend::Projection) {
+            model4D = nullptr; //    
+        }
+        if (model4D) {
+            model4D->InitProjectionBuffers(); //       ,   
+        }
+
+        //   (,   )           uniform'
+        glm::vec3 boundsMin, boundsMax;
+        glm::mat4 modelMatrix = GetModelMatrix(model);
+        bool sliceVisible = model->GetLocalBounds(boundsMin, boundsMax) && frustum.IsBoxVisible(boundsMin, boundsMax, modelMatrix);
+        bool skeletonVisible = false;
+        if (model4D) {
+            model4D->GetProjectionBounds(boundsMin, boundsMax);
+            skeletonVisible = frustum.IsBoxVisible(boundsMin, boundsMax, modelMatrix);
+        }
+        if (!sliceVisible && !skeletonVisible) {
+            ++culledModels;
+            continue;
+        }
+        if (sliceVisible) {
+            DrawModel(model);
+        }
+        if (skeletonVisible) {
+            DrawSkeleton(model4D);
+        }
+        ++drawnModels;
     }
+
+    PROFILE_GPU_END(ProfileStage::Draw);
 }
 
 //  
@@ -275,13 +612,101 @@ void Renderer::AddModel(Model* model) {
     model->InitBuffers();
 }
 
+//      
+glm::mat4 Renderer::GetModelMatrix(const Model* model) const {
+    glm::mat4 modelMatrix = glm::mat4(1.0f);
+    modelMatrix = glm::translate(modelMatrix, model->GetPosition());
+    modelMatrix = glm::scale(modelMatrix, model->GetSize());
+    return modelMatrix;
+}
+
 //   
 void Renderer::DrawModel(const Model* model) {
 
+    const Model4D* model4D = dynamic_cast<const Model4D*>(model);
+    SliceBackend backend = model4D ? model4D->GetSliceBackend() : SliceBackend::CPU;
+
+    //   GPU  :   
+    if (backend == SliceBackend::Compute) {
+        model4D->DispatchComputeSlice(shaderPrograms["sliceEdges"], shaderPrograms["sliceCells"]);
+    }
+
+    //       4D   ,    
+    const char* programName = backend == SliceBackend::Tetrahedral ? "tetraSlice"
+        : backend == SliceBackend::Projection ? projectionPrograms[(int)model4D->GetProjectionMode()] : "mainShader";
+    GLuint program = shaderPrograms[programName];
+    glUseProgram(program);
+
+    SetModelUniforms(program, model);
+
+    //  
+    if (backend == SliceBackend::Compute) {
+        model4D->DrawComputeSlice();
+        return;
+    }
+    if (backend == SliceBackend::Tetrahedral) {
+        model4D->SetSliceUniforms(program);
+        model4D->DrawTetraSlice();
+        return;
+    }
+    if (backend == SliceBackend::Projection) {
+        DrawProjection(model4D, program);
+        return;
+    }
+
+    SliceRenderMode mode = model4D ? sliceRenderMode : SliceRenderMode::Filled;
+    if (mode != SliceRenderMode::Wireframe) {
+        //       ,    
+        if (mode == SliceRenderMode::Overlay) {
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(1.0f, 1.0f);
+        }
+        glBindVertexArray(model->GetVAO());
+        glDrawElements(GL_TRIANGLES, model->GetIndices().size(), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+        glDisable(GL_POLYGON_OFFSET_FILL);
+    }
+    if (mode != SliceRenderMode::Filled) {
+        if (mode == SliceRenderMode::Overlay) {
+            glm::vec3 edgeColor = model->GetColor() * 0.25f; //   ,      
+            glUniform3f(glGetUniformLocation(program, "objectColor"), edgeColor.x, edgeColor.y, edgeColor.z);
+        }
+        model4D->DrawSliceEdges();
+    }
+}
+
+void Renderer::DrawProjection(const Model4D* model, GLuint program) {
+    model->SetProjectionUniforms(program);
+
+    //      ,       
+    if (sliceRenderMode != SliceRenderMode::Wireframe) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+        glUniform1f(glGetUniformLocation(program, "alpha"), 0.25f);
+        model->DrawProjectedFaces();
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+    if (sliceRenderMode != SliceRenderMode::Filled) {
+        glUniform1f(glGetUniformLocation(program, "alpha"), 1.0f);
+        model->DrawProjectedEdges();
+    }
+}
+
+void Renderer::DrawSkeleton(const Model4D* model) {
+    //     ,  CPU   
+    GLuint program = shaderPrograms[projectionPrograms[(int)model->GetProjectionMode()]];
+    glUseProgram(program);
+    SetModelUniforms(program, model);
+    model->SetProjectionUniforms(program);
+    glUniform1f(glGetUniformLocation(program, "alpha"), 1.0f);
+    model->DrawProjectedEdges();
+}
+
+void Renderer::SetModelUniforms(GLuint program, const Model* model) {
     //   model, view  projection
-    glm::mat4 modelMatrix = glm::mat4(1.0f);
-    modelMatrix = glm::translate(modelMatrix, model->GetPosition());
-    modelMatrix = glm::scale(modelMatrix, model->GetSize());
+    glm::mat4 modelMatrix = GetModelMatrix(model);
     glm::mat4 view = camera->GetViewMatrix();
     glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)800 / (float)600, 0.1f, 100.0f);
 
@@ -289,30 +714,25 @@ void Renderer::DrawModel(const Model* model) {
     glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
 
     //    
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms["mainShader"], "model"), 1, GL_FALSE, glm::value_ptr(modelMatrix));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms["mainShader"], "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms["mainShader"], "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix3fv(glGetUniformLocation(shaderPrograms["mainShader"], "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
+    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, glm::value_ptr(modelMatrix));
+    glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniformMatrix3fv(glGetUniformLocation(program, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normalMatrix));
 
     //   
     int lightCount = std::min((int)lights.size(), 10);
-    glUniform1i(glGetUniformLocation(shaderPrograms["mainShader"], "lightCount"), lightCount);
+    glUniform1i(glGetUniformLocation(program, "lightCount"), lightCount);
 
     for (int i = 0; i < lightCount; i++) {
         std::string lightPosStr = "lights[" + std::to_string(i) + "].position";
         std::string lightColorStr = "lights[" + std::to_string(i) + "].color";
-        glUniform3f(glGetUniformLocation(shaderPrograms["mainShader"], lightPosStr.c_str()), lights[i]->GetPosition().x, lights[i]->GetPosition().y, lights[i]->GetPosition().z);
-        glUniform3f(glGetUniformLocation(shaderPrograms["mainShader"], lightColorStr.c_str()), lights[i]->GetColor().x, lights[i]->GetColor().y, lights[i]->GetColor().z);
+        glUniform3f(glGetUniformLocation(program, lightPosStr.c_str()), lights[i]->GetPosition().x, lights[i]->GetPosition().y, lights[i]->GetPosition().z);
+        glUniform3f(glGetUniformLocation(program, lightColorStr.c_str()), lights[i]->GetColor().x, lights[i]->GetColor().y, lights[i]->GetColor().z);
     }
 
     //   
-    glUniform3f(glGetUniformLocation(shaderPrograms["mainShader"], "viewPos"), camera->GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
-    glUniform3f(glGetUniformLocation(shaderPrograms["mainShader"], "objectColor"), model->GetColor().x, model->GetColor().y, model->GetColor().z);
-
-    //  
-    glBindVertexArray(model->GetVAO());
-    glDrawElements(GL_TRIANGLES, model->GetIndices().size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    glUniform3f(glGetUniformLocation(program, "viewPos"), camera->GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
+    glUniform3f(glGetUniformLocation(program, "objectColor"), model->GetColor().x, model->GetColor().y, model->GetColor().z);
 }
 
 void Renderer::RenderFullscreenQuad() {
@@ -346,48 +766,137 @@ void Renderer::RenderFullscreenQuad() {
     glBindVertexArray(0);
 }
 
+void Renderer::SetRaymarchTarget(const Model4D* model, SDF4DShape shape) {
+    raymarchTarget = model;
+    raymarchShape = shape;
+}
+
+void Renderer::SetRaymarchBudget(int steps, int shadowSteps, int bounces) {
+    raymarchSteps = std::max(steps, 1);
+    raymarchShadowSteps = std::max(shadowSteps, 0);
+    raymarchBounces = std::max(bounces, 1);
+}
+
+void Renderer::SetRaymarchResolution(int divisor) {
+    divisor = divisor >= 4 ? 4 : divisor >= 2 ? 2 : 1;
+    if (divisor == raymarchDivisor) {
+        return;
+    }
+    raymarchDivisor = divisor;
+    InitTraceBuffers();
+}
+
 void Renderer::PostProcessing() {
+    if (!postProcessing) {
+        return;
+    }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); //    
+    PROFILE_SCOPE(ProfileStage::Post);
+    PROFILE_GPU_BEGIN(ProfileStage::Post);
+
+    //        ,     raymarchUpsample
+    bool reduced = raymarchDivisor > 1;
+    if (reduced) {
+        glBindFramebuffer(GL_FRAMEBUFFER, traceFBO);
+        glViewport(0, 0, traceWidth, traceHeight);
+    }
+    else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0); //    
+    }
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     shaderProgram = shaderPrograms["raymarching"];
     glUseProgram(shaderProgram);
-    
-	//InitFrameBuffers();
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, colorBufferTexture);
-    glUniform1i(glGetUniformLocation(shaderPrograms["raymarching"], "sceneColor"), 0);
+    glUniform1i(glGetUniformLocation(shaderProgram, "sceneColor"), 0);
 
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, depthBufferTexture);
-    glUniform1i(glGetUniformLocation(shaderPrograms["raymarching"], "sceneDepth"), 1);
-    
+    glUniform1i(glGetUniformLocation(shaderProgram, "sceneDepth"), 1);
 
-    //   
+    //     ,      
     glm::mat4 view = camera->GetViewMatrix();
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
-    glm::mat4 projInverse = glm::inverse(projection);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)800 / (float)600, 0.1f, 100.0f);
+    glm::mat4 invViewProjection = glm::inverse(projection * view);
 
-    glUniform3fv(glGetUniformLocation(shaderPrograms["raymarching"], "camPos"), 1, glm::value_ptr(view));
-    glUniformMatrix3fv(glGetUniformLocation(shaderPrograms["raymarching"], "camRot"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms["raymarching"], "projInverse"), 1, GL_FALSE, glm::value_ptr(projInverse));
+    glUniform3fv(glGetUniformLocation(shaderProgram, "camPos"), 1, glm::value_ptr(camera->GetPosition()));
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "invViewProjection"), 1, GL_FALSE, glm::value_ptr(invViewProjection));
 
+    //  
+    int lightCount = std::min((int)lights.size(), 10);
+    glUniform1i(glGetUniformLocation(shaderProgram, "numLights"), lightCount);
+    for (int i = 0; i < lightCount; i++) {
+        glUniform3fv(glGetUniformLocation(shaderProgram, ("lights[" + std::to_string(i) + "].position").c_str()), 1, glm::value_ptr(lights[i]->GetPosition()));
+        glUniform3fv(glGetUniformLocation(shaderProgram, ("lights[" + std::to_string(i) + "].color").c_str()), 1, glm::value_ptr(lights[i]->GetColor()));
+    }
 
-    // 2.  
-    glUniform1i(glGetUniformLocation(shaderPrograms["raymarching"], "numLights"), 3);
-    for (int i = 0; i < 2; i++) {
-        glUniform3fv(glGetUniformLocation(shaderPrograms["raymarching"], ("lights[" + std::to_string(i) + "].position").c_str()), 1, glm::value_ptr(lights[i]->GetPosition()));
-        glUniform3fv(glGetUniformLocation(shaderPrograms["raymarching"], ("lights[" + std::to_string(i) + "].color").c_str()), 1, glm::value_ptr(lights[i]->GetColor()));
+    // 
+    glUniform1f(glGetUniformLocation(shaderProgram, "reflectivity"), 0.5f);
+    glUniform1f(glGetUniformLocation(shaderProgram, "shadowIntensity"), 0.8f);
+
+    glUniform1i(glGetUniformLocation(shaderProgram, "maxSteps"), raymarchSteps);
+    glUniform1i(glGetUniformLocation(shaderProgram, "maxShadowSteps"), raymarchShadowSteps);
+    glUniform1i(glGetUniformLocation(shaderProgram, "maxBounces"), raymarchBounces);
+
+    //           45
+    float traceRows = reduced ? (float)traceHeight : screenHeight;
+    glUniform1f(glGetUniformLocation(shaderProgram, "pixelFootprint"), 2.0f * std::tan(glm::radians(45.0f) * 0.5f) / traceRows);
+    glUniform1i(glGetUniformLocation(shaderProgram, "compositeScene"), reduced ? GL_FALSE : GL_TRUE);
+
+    // 4D-:           
+    glm::mat4 inverseTransform4D(1.0f);
+    glm::vec4 offset4D(0.0f);
+    glm::vec3 position(0.0f), size(1.0f), color(1.0f);
+    float wSlice = 0.0f, boundingRadius = 0.0f;
+    if (raymarchTarget) {
+        inverseTransform4D = glm::transpose(raymarchTarget->GetTransform4D()); //  
+        offset4D = raymarchTarget->GetOffset4D();
+        position = raymarchTarget->GetPosition();
+        size = raymarchTarget->GetSize();
+        color = raymarchTarget->GetColor();
+        wSlice = raymarchTarget->GetWSlice();
+
+        //     4D-  1,    3D-     offset4D
+        glm::vec3 offset3D(offset4D);
+        boundingRadius = (1.0f + glm::length(offset3D)) * std::max(size.x, std::max(size.y, size.z));
     }
+    glUniform1i(glGetUniformLocation(shaderProgram, "shapeType"), (int)raymarchShape);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "inverseTransform4D"), 1, GL_FALSE, glm::value_ptr(inverseTransform4D));
+    glUniform4fv(glGetUniformLocation(shaderProgram, "offset4D"), 1, glm::value_ptr(offset4D));
+    glUniform1f(glGetUniformLocation(shaderProgram, "wSlice"), wSlice);
+    glUniform3fv(glGetUniformLocation(shaderProgram, "objectPosition"), 1, glm::value_ptr(position));
+    glUniform3fv(glGetUniformLocation(shaderProgram, "objectSize"), 1, glm::value_ptr(size));
+    glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, glm::value_ptr(color));
+    glUniform1f(glGetUniformLocation(shaderProgram, "boundingRadius"), boundingRadius);
+
+    glDisable(GL_DEPTH_TEST);
+    RenderFullscreenQuad();
 
-    // 3. 
-    glUniform1f(glGetUniformLocation(shaderPrograms["raymarching"], "reflectivity"), 0.5f);
-    glUniform1f(glGetUniformLocation(shaderPrograms["raymarching"], "shadowIntensity"), 0.8f);
+    if (reduced) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, (GLsizei)screenWidth, (GLsizei)screenHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    RenderFullscreenQuad();
+        GLuint upsample = shaderPrograms["raymarchUpsample"];
+        glUseProgram(upsample);
+        glUniform1i(glGetUniformLocation(upsample, "sceneColor"), 0);
+        glUniform1i(glGetUniformLocation(upsample, "sceneDepth"), 1);
+
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, traceTexture);
+        glUniform1i(glGetUniformLocation(upsample, "tracedColor"), 2);
+        glActiveTexture(GL_TEXTURE0);
+
+        glUniform3fv(glGetUniformLocation(upsample, "camPos"), 1, glm::value_ptr(camera->GetPosition()));
+        glUniformMatrix4fv(glGetUniformLocation(upsample, "invViewProjection"), 1, GL_FALSE, glm::value_ptr(invViewProjection));
+
+        RenderFullscreenQuad();
+    }
+    glEnable(GL_DEPTH_TEST);
 
+    PROFILE_GPU_END(ProfileStage::Post);
 }
 
 void Renderer::ProcessInput(GLFWwindow* window, float deltaTime) {
@@ -409,4 +918,86 @@ void Renderer::ProcessInput(GLFWwindow* window, float deltaTime) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_RELEASE) {
         escPressed = false;
     }
+
+    //  4D-  : CPU-,  , ,   4D
+    static bool gPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS && !gPressed) {
+        gPressed = true;
+        for (auto model : models) {
+            if (auto model4D = dynamic_cast<Model4D*>(model)) {
+                switch (model4D->GetSliceBackend()) {
+                    case SliceBackend::CPU: model4D->SetSliceBackend(SliceBackend::Compute); break;
+                    case SliceBackend::Compute: model4D->SetSliceBackend(SliceBackend::Tetrahedral); break;
+                    case SliceBackend::Tetrahedral: model4D->SetSliceBackend(SliceBackend::Projection); break;
+                    case SliceBackend::Projection: model4D->SetSliceBackend(SliceBackend::CPU); break;
+                }
+                model4D->InitBuffers();
+            }
+        }
+    }
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_RELEASE) {
+        gPressed = false;
+    }
+
+    // R   4D-, T  
+    static bool rPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && !rPressed) {
+        rPressed = true;
+        postProcessing = !postProcessing;
+    }
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_RELEASE) {
+        rPressed = false;
+    }
+
+    static bool tPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS && !tPressed) {
+        tPressed = true;
+        raymarchShape = (SDF4DShape)(((int)raymarchShape + 1) % 4);
+    }
+    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_RELEASE) {
+        tPressed = false;
+    }
+
+    // Y   : , 1/2, 1/4
+    static bool yPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS && !yPressed) {
+        yPressed = true;
+        SetRaymarchResolution(raymarchDivisor == 4 ? 1 : raymarchDivisor * 2);
+    }
+    if (glfwGetKey(window, GLFW_KEY_Y) == GLFW_RELEASE) {
+        yPressed = false;
+    }
+
+    // L   : , ,   ; K  4D-
+    static bool lPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS && !lPressed) {
+        lPressed = true;
+        sliceRenderMode = (SliceRenderMode)(((int)sliceRenderMode + 1) % 3);
+    }
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_RELEASE) {
+        lPressed = false;
+    }
+
+    static bool kPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS && !kPressed) {
+        kPressed = true;
+        skeleton = !skeleton;
+    }
+    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_RELEASE) {
+        kPressed = false;
+    }
+
+    // P    4D-: , , 
+    static bool pPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !pPressed) {
+        pPressed = true;
+        for (auto model : models) {
+            if (auto model4D = dynamic_cast<Model4D*>(model)) {
+                model4D->SetProjectionMode((ProjectionMode)(((int)model4D->GetProjectionMode() + 1) % 3));
+            }
+        }
+    }
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE) {
+        pPressed = false;
+    }
 }
\ No newline at end of file
@@ -9,22 +9,37 @@
 #include "light.h"
 #include "model.h"
 #include "model4D.h"
+#include "frustum.h"
+#include "shaderCache.h"
+#include "shaderWatcher.h"
+
+//   CPU- 4D-: ,      
+enum class SliceRenderMode {
+    Filled,
+    Wireframe,
+    Overlay
+};
 
 class Renderer {
 public:
-    Renderer(int width, int height, const char* title);
+    Renderer(int width, int height, const char* title, const std::string& shaderDirectory = ""); //    
     ~Renderer();
 
-    void Time(); //   
     void Clear();  //  
     void SwapBuffers(); //  
+    void SetVSync(bool enabled);
     bool ShouldClose(); //   
-    void PollEvents();  //  
+    void PollEvents(float deltaTime);  //  ;     FrameScheduler
 
     void InitBuffers();
     
     std::map<std::string, GLuint> shaderPrograms; // 
-    void InitShaders();
+    void InitShaders(); //       
+    bool PollShaders(); //   ; true,   
+    void FinishShaders(); //    
+    void ReloadChangedShaders(); //  ,     
+    bool ReloadProgram(const std::string& name); //     
+    const std::string& GetShaderDirectory() const { return shaderDirectory; }
     void InitFrameBuffers();
 
     void AddModel(Model* model); //  
@@ -32,33 +47,76 @@ public:
     void PostProcessing(); //      
     void ProcessInput(GLFWwindow* window, float deltaTime); //  
 
-	double GetDeltaTime() const { return deltaTime; } //   
     GLFWwindow* GetWindow() const { return window; } //    
     Camera* GetCamera() const { return camera; } //    
     Camera* GetScreenCamera() const { return screenCamera; } //     
+    int GetDrawnModelCount() const { return drawnModels; } //  ,    
+    int GetCulledModelCount() const { return culledModels; } //  ,    
+
+    void SetPostProcessing(bool enabled) { postProcessing = enabled; } //    FBO   4D- 
+    bool IsPostProcessing() const { return postProcessing; }
+    void SetRaymarchTarget(const Model4D* model, SDF4DShape shape); //  4D-    
+    void SetRaymarchBudget(int steps, int shadowSteps, int bounces); //     
+    void SetRaymarchResolution(int divisor); //   1/divisor  (1, 2  4)   
+    int GetRaymarchResolution() const { return raymarchDivisor; }
+    void SetSliceRenderMode(SliceRenderMode mode) { sliceRenderMode = mode; }
+    SliceRenderMode GetSliceRenderMode() const { return sliceRenderMode; }
+    void SetSkeleton(bool enabled) { skeleton = enabled; } //   4D-     4D
+    bool IsSkeleton() const { return skeleton; }
 
 private:
     GLFWwindow* window;
     float screenWidth, screenHeight;
     GLuint VAO, VBO, EBO, shaderProgram;
     GLuint quadVAO = 0, quadVBO;
-    GLuint fbo, colorBufferTexture, depthBufferTexture;
+    GLuint fbo = 0, colorBufferTexture = 0, depthBufferTexture = 0;
+    bool postProcessing = false;
+    SliceRenderMode sliceRenderMode = SliceRenderMode::Filled;
+    bool skeleton = false;
+    const Model4D* raymarchTarget = nullptr;
+    SDF4DShape raymarchShape = SDF4DShape::Tesseract;
+    int raymarchSteps = 64, raymarchShadowSteps = 16, raymarchBounces = 2;
+    int raymarchDivisor = 1;
+    GLuint traceFBO = 0, traceTexture = 0; //    
+    int traceWidth = 0, traceHeight = 0;
     Camera* camera; //    
     Camera* screenCamera;
     std::vector<Light*> lights; //   
     std::vector<Model*> models; //  
-
-    double lastTime, currentTime, deltaTime;
+    Frustum frustum; //    
+    ShaderCache shaderCache{ "shaderCache" }; //    
+    std::string shaderDirectory; //     
+    ShaderWatcher shaderWatcher;
+    int drawnModels = 0, culledModels = 0;
 
   //  
     void DrawModel(const Model* model); //   
+    void DrawProjection(const Model4D* model, GLuint program); //      4D  sliceRenderMode
+    void DrawSkeleton(const Model4D* model); // и 4D-     
+    void SetModelUniforms(GLuint program, const Model* model); // ,    
+    glm::mat4 GetModelMatrix(const Model* model) const; //      
     void RenderFullscreenQuad(); //         
+    void InitTraceBuffers(); // ()     raymarchDivisor
+
+    // ,   ,    
+    struct PendingProgram {
+        std::string name;
+        std::string source; //  
+        GLuint program = 0;
+        std::vector<GLuint> shaders;
+    };
+    std::vector<PendingProgram> pendingPrograms;
+    bool parallelCompile = false; //  GL_KHR/ARB_parallel_shader_compile
 
     GLuint CompileShader(GLenum shaderType, const std::string& shaderSource);
-    GLuint CreateProgram(GLuint vertexShader, GLuint fragmentShader);
+    GLuint CreateProgram(const std::vector<GLuint>& shaders);
+    void SubmitProgram(const std::string& name, const std::string& source, const std::vector<std::pair<GLenum, const std::string*>>& stages);
+    bool FinishProgram(const PendingProgram& pending);
+    bool ReadShaderSource(const std::string& file, std::string& source, bool& readFailed); //     ; readFailed   ,   
+    bool ReadProgramStages(const std::string& name, std::vector<std::pair<GLenum, std::string>>& stages, std::string& source); //   name; false   
     std::vector<std::string> GetShaderFiles(const std::string& directory);
-    void CheckShaderCompileError(GLuint shader, const std::string& shaderType);
-    void CheckProgramLinkError(GLuint program);
+    bool CheckShaderCompileError(GLuint shader, const std::string& shaderType);
+    bool CheckProgramLinkError(GLuint program);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "rotation4D.h"
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+
+//    (0, v): cos|v| + sin|v| * v / |v|
+static glm::quat ExpPure(const glm::vec3& v) {
+    float angle = glm::length(v);
+    if (angle < 1e-8f) {
+        return glm::normalize(glm::quat(1.0f, v.x, v.y, v.z));
+    }
+    glm::vec3 axis = v * (std::sin(angle) / angle);
+    return glm::quat(std::cos(angle), axis.x, axis.y, axis.z);
+}
+
+//     :        
+static glm::quat SlerpNoFlip(const glm::quat& from, const glm::quat& to, float alpha) {
+    float cosAngle = glm::clamp(glm::dot(from, to), -1.0f, 1.0f);
+    if (std::abs(cosAngle) > 0.9995f) {
+        return glm::normalize(from * (1.0f - alpha) + to * alpha);
+    }
+    float angle = std::acos(cosAngle);
+    float sinAngle = std::sin(angle);
+    return from * (std::sin((1.0f - alpha) * angle) / sinAngle) + to * (std::sin(alpha * angle) / sinAngle);
+}
+
+Rotation4D Rotation4D::Exp(const Bivector4D& b) {
+    //        :   L(u) + R(v)
+    glm::vec3 u(b.yz - b.xw, -b.xz - b.yw, b.xy - b.zw);
+    glm::vec3 v(-b.yz - b.xw, b.xz - b.yw, -b.xy - b.zw);
+    return Rotation4D(ExpPure(u * 0.5f), ExpPure(v * 0.5f));
+}
+
+Rotation4D Rotation4D::Plane(RotationPlane4D plane, float angle) {
+    Bivector4D b;
+    switch (plane) {
+        case RotationPlane4D::XY: b.xy = angle; break;
+        case RotationPlane4D::XZ: b.xz = angle; break;
+        case RotationPlane4D::YZ: b.yz = angle; break;
+        case RotationPlane4D::XW: b.xw = angle; break;
+        case RotationPlane4D::YW: b.yw = angle; break;
+        case RotationPlane4D::ZW: b.zw = angle; break;
+    }
+    return Exp(b);
+}
+
+Rotation4D Rotation4D::Slerp(const Rotation4D& from, const Rotation4D& to, float alpha) {
+    //  (l, r)  (-l, -r)   :  ,    from    
+    float leftAngle = std::acos(glm::clamp(glm::dot(from.left, to.left), -1.0f, 1.0f));
+    float rightAngle = std::acos(glm::clamp(glm::dot(from.right, to.right), -1.0f, 1.0f));
+    float pi = glm::pi<float>();
+    bool flip = (pi - leftAngle) * (pi - leftAngle) + (pi - rightAngle) * (pi - rightAngle) < leftAngle * leftAngle + rightAngle * rightAngle;
+
+    glm::quat toLeft = flip ? -to.left : to.left;
+    glm::quat toRight = flip ? -to.right : to.right;
+    return Rotation4D(SlerpNoFlip(from.left, toLeft, alpha), SlerpNoFlip(from.right, toRight, alpha));
+}
+
+Rotation4D Rotation4D::operator*(const Rotation4D& other) const {
+    // left * (other.left * v * other.right) * right;        
+    return Rotation4D(glm::normalize(left * other.left), glm::normalize(other.right * right));
+}
+
+glm::vec4 Rotation4D::Rotate(const glm::vec4& v) const {
+    glm::quat result = left * glm::quat(v.w, v.x, v.y, v.z) * right;
+    return glm::vec4(result.x, result.y, result.z, result.w);
+}
+
+glm::mat4 Rotation4D::ToMatrix() const {
+    return glm::mat4(
+        Rotate(glm::vec4(1.0f, 0.0f, 0.0f, 0.0f)),
+        Rotate(glm::vec4(0.0f, 1.0f, 0.0f, 0.0f)),
+        Rotate(glm::vec4(0.0f, 0.0f, 1.0f, 0.0f)),
+        Rotate(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f))
+    );
+}
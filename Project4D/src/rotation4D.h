@@ -0,0 +1,52 @@
+#ifndef ROTATION4D_H
+#define ROTATION4D_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+enum class RotationPlane4D {
+    XY,
+    XZ,
+    YZ,
+    XW,
+    YW,
+    ZW
+};
+
+// :  (  )     ;   ab   a   b
+struct Bivector4D {
+    float xy = 0.0f, xz = 0.0f, yz = 0.0f, xw = 0.0f, yw = 0.0f, zw = 0.0f;
+
+    Bivector4D() = default;
+    Bivector4D(float xy, float xz, float yz, float xw, float yw, float zw) : xy(xy), xz(xz), yz(yz), xw(xw), yw(yw), zw(zw) {}
+
+    Bivector4D operator*(float scale) const { return Bivector4D(xy * scale, xz * scale, yz * scale, xw * scale, yw * scale, zw * scale); }
+    Bivector4D operator+(const Bivector4D& other) const {
+        return Bivector4D(xy + other.xy, xz + other.xz, yz + other.yz, xw + other.xw, yw + other.yw, zw + other.zw);
+    }
+};
+
+//  4D    : v -> left * v * right,  v = (x, y, z, w) ~ w + xi + yj + zk.
+//     ,  ,       
+class Rotation4D {
+public:
+    Rotation4D() : left(1.0f, 0.0f, 0.0f, 0.0f), right(1.0f, 0.0f, 0.0f, 0.0f) {}
+
+    static Rotation4D Exp(const Bivector4D& bivector); //        bivector
+    static Rotation4D Plane(RotationPlane4D plane, float angle); //    
+    static Rotation4D Slerp(const Rotation4D& from, const Rotation4D& to, float alpha); //     
+
+    Rotation4D operator*(const Rotation4D& other) const; //  other,  this
+    glm::vec4 Rotate(const glm::vec4& v) const;
+    glm::mat4 ToMatrix() const; //       ,     
+
+    const glm::quat& GetLeft() const { return left; }
+    const glm::quat& GetRight() const { return right; }
+
+private:
+    Rotation4D(const glm::quat& left, const glm::quat& right) : left(left), right(right) {}
+
+    glm::quat left, right;
+};
+
+#endif
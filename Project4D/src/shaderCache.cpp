@@ -0,0 +1,134 @@
+#include "shaderCache.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+//   ,    length   
+struct ShaderCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+};
+
+static const char cacheMagic[4] = { 'P', '4', 'D', 'S' };
+static const uint32_t cacheVersion = 1;
+
+uint64_t ShaderCache::Hash(const std::string& data, uint64_t hash) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void ShaderCache::Init() {
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    enabled = formats > 0;
+    if (!enabled) {
+        return;
+    }
+
+    const char* vendor = (const char*)glGetString(GL_VENDOR);
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    const char* version = (const char*)glGetString(GL_VERSION);
+    driver = std::string(vendor ? vendor : "") + "|" + (renderer ? renderer : "") + "|" + (version ? version : "");
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+}
+
+std::string ShaderCache::GetPath(const std::string& name) const {
+    return (std::filesystem::path(directory) / (name + ".bin")).string();
+}
+
+GLuint ShaderCache::LoadProgram(const std::string& name, const std::string& source) {
+    if (!enabled) {
+        return 0;
+    }
+
+    std::ifstream file(GetPath(name), std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    //       ,     
+    std::streamoff size = file.tellg();
+    ShaderCacheHeader header;
+    if (size < (std::streamoff)sizeof(header)) {
+        return 0;
+    }
+    file.seekg(0);
+    file.read((char*)&header, sizeof(header));
+    if (!file || std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion ||
+        header.key != GetKey(source) || size != (std::streamoff)(sizeof(header) + header.length)) {
+        return 0;
+    }
+
+    buffer.resize(header.length);
+    file.read(buffer.data(), header.length);
+    if (!file) {
+        return 0;
+    }
+
+    //         
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, buffer.data(), header.length);
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderCache::StoreProgram(const std::string& name, const std::string& source, GLuint program) {
+    if (!enabled) {
+        return;
+    }
+
+    GLint success = GL_FALSE, length = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (!success || length <= 0) {
+        return;
+    }
+
+    ShaderCacheHeader header;
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.key = GetKey(source);
+
+    buffer.resize(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, buffer.data());
+    if (written <= 0) {
+        return;
+    }
+    header.format = format;
+    header.length = (uint32_t)written;
+
+    //    ,       
+    std::string path = GetPath(name);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "  : " << tempPath << std::endl;
+            return;
+        }
+        file.write((const char*)&header, sizeof(header));
+        file.write(buffer.data(), written);
+        if (!file.good()) {
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+}
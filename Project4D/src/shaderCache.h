@@ -0,0 +1,33 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//     .         ,
+//          
+class ShaderCache {
+public:
+    ShaderCache(const std::string& directory) : directory(directory) {}
+
+    void Init(); //         (  OpenGL)
+    bool IsEnabled() const { return enabled; }
+
+    GLuint LoadProgram(const std::string& name, const std::string& source); // 0,      
+    void StoreProgram(const std::string& name, const std::string& source, GLuint program);
+
+    static uint64_t Hash(const std::string& data, uint64_t hash = 14695981039346656037ull); // FNV-1a
+
+private:
+    std::string directory;
+    std::string driver; // GL_VENDOR, GL_RENDERER  GL_VERSION
+    bool enabled = false;
+    std::vector<char> buffer; //     
+
+    std::string GetPath(const std::string& name) const;
+    uint64_t GetKey(const std::string& source) const { return Hash(source, Hash(driver)); }
+};
+
+#endif
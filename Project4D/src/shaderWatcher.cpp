@@ -0,0 +1,113 @@
+#include "shaderWatcher.h"
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+static bool IsShaderFile(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    return extension == ".vert" || extension == ".frag" || extension == ".geom" || extension == ".comp";
+}
+
+ShaderWatcher::~ShaderWatcher() {
+    Stop();
+}
+
+bool ShaderWatcher::Start(const std::string& directory) {
+    Stop();
+    this->directory = directory;
+
+#ifdef __linux__
+    //     ,    
+    inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyHandle >= 0 && inotify_add_watch(inotifyHandle, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0) {
+        return true;
+    }
+    if (inotifyHandle >= 0) {
+        close(inotifyHandle);
+        inotifyHandle = -1;
+    }
+    std::cerr << " inotify   " << directory << ",  " << std::endl;
+#endif
+
+    ScanWriteTimes(nullptr);
+    lastScan = glfwGetTime();
+    return std::filesystem::is_directory(directory);
+}
+
+void ShaderWatcher::Stop() {
+#ifdef __linux__
+    if (inotifyHandle >= 0) {
+        close(inotifyHandle);
+        inotifyHandle = -1;
+    }
+#endif
+    writeTimes.clear();
+    directory.clear();
+}
+
+std::vector<std::string> ShaderWatcher::PollChanged() {
+    std::vector<std::string> changed;
+    if (directory.empty()) {
+        return changed; //   
+    }
+
+#ifdef __linux__
+    if (inotifyHandle >= 0) {
+        alignas(inotify_event) char events[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+        ssize_t length;
+        while ((length = read(inotifyHandle, events, sizeof(events))) > 0) {
+            for (char* pointer = events; pointer < events + length;) {
+                const inotify_event* event = (const inotify_event*)pointer;
+                if (event->len > 0) {
+                    std::filesystem::path path(event->name);
+                    if (IsShaderFile(path)) {
+                        changed.push_back(path.stem().string());
+                    }
+                }
+                pointer += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+    else
+#endif
+    {
+        double now = glfwGetTime();
+        if (now - lastScan >= 0.5) {
+            lastScan = now;
+            ScanWriteTimes(&changed);
+        }
+    }
+
+    //       
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    return changed;
+}
+
+void ShaderWatcher::ScanWriteTimes(std::vector<std::string>* changed) {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (!IsShaderFile(entry.path())) {
+            continue;
+        }
+        auto writeTime = entry.last_write_time(error);
+        if (error) {
+            continue;
+        }
+
+        std::string file = entry.path().filename().string();
+        auto it = writeTimes.find(file);
+        if (it == writeTimes.end() || it->second != writeTime) {
+            if (changed) {
+                changed->push_back(entry.path().stem().string());
+            }
+            writeTimes[file] = writeTime;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <filesystem>
+
+//    .  Linux  inotify,     
+//        .  ,    
+class ShaderWatcher {
+public:
+    ShaderWatcher() = default;
+    ~ShaderWatcher();
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+    bool Start(const std::string& directory);
+    void Stop();
+    std::vector<std::string> PollChanged(); //  ( )  
+
+private:
+    std::string directory;
+    int inotifyHandle = -1;
+    std::map<std::string, std::filesystem::file_time_type> writeTimes; //    inotify
+    double lastScan = 0.0;
+
+    void ScanWriteTimes(std::vector<std::string>* changed);
+};
+
+#endif
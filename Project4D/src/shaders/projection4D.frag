@@ -0,0 +1,16 @@
+#version 440 core
+
+in float Depth4D;
+
+uniform vec3 objectColor;
+uniform float alpha;       //  ,  
+uniform float focalLength;
+uniform float radius4D;    //  :    [focalLength - radius4D, focalLength + radius4D]
+
+out vec4 FragColor;
+
+void main() {
+    //   w     ,   
+    float depth = clamp((Depth4D - (focalLength - radius4D)) / max(2.0 * radius4D, 1e-3), 0.0, 1.0);
+    FragColor = vec4(objectColor * mix(1.0, 0.35, depth), alpha);
+}
@@ -0,0 +1,38 @@
+#version 440 core
+
+layout(location = 0) in vec4 aPos4D; //    
+
+out float Depth4D; //        4D
+
+uniform mat4 transform4D;
+uniform vec4 offset4D;
+uniform mat4 camera4D;     //  4D-:    ,      
+uniform vec4 eye4D;
+uniform float focalLength; //      :     1
+uniform float radius4D;    //  3-  
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+    // 4D-     GPU,    
+    vec4 local = camera4D * (transform4D * aPos4D + offset4D - eye4D);
+    Depth4D = -local.w;
+
+    //    #define   ,     
+#if defined(PROJECTION_ORTHOGRAPHIC)
+    // : w  
+    vec3 projected = eye4D.xyz + local.xyz;
+#elif defined(PROJECTION_STEREOGRAPHIC)
+    // :    3-           
+    vec4 centered = local + vec4(0.0, 0.0, 0.0, focalLength);
+    vec4 onSphere = centered / max(length(centered), 1e-6);
+    vec3 projected = eye4D.xyz + radius4D * onSphere.xyz / max(1.0 - onSphere.w, 1e-3);
+#else
+    //   
+    vec3 projected = eye4D.xyz + local.xyz * focalLength / max(Depth4D, 1e-3);
+#endif
+
+    gl_Position = projection * view * model * vec4(projected, 1.0);
+}
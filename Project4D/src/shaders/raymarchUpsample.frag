@@ -0,0 +1,61 @@
+#version 440 core
+
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D sceneColor;
+uniform sampler2D sceneDepth;
+uniform sampler2D tracedColor; // rgb   , a     (< 0  )
+
+uniform vec3 camPos;
+uniform mat4 invViewProjection;
+
+//          
+float sceneDistance(vec2 uv) {
+    float depth = texture(sceneDepth, uv).r;
+    if (depth >= 1.0) return 1e9;
+    vec4 p = invViewProjection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return length(p.xyz / p.w - camPos);
+}
+
+void main() {
+    vec2 traceSize = vec2(textureSize(tracedColor, 0));
+    vec2 texel = TexCoords * traceSize - 0.5;
+    ivec2 base = ivec2(floor(texel));
+    vec2 f = fract(texel);
+
+    float tScene = sceneDistance(TexCoords);
+
+    //    :  ,        
+    vec4 samples[4];
+    float nearest = 1e9;
+    for (int i = 0; i < 4; i++) {
+        ivec2 coord = clamp(base + ivec2(i & 1, i >> 1), ivec2(0), ivec2(traceSize) - 1);
+        samples[i] = texelFetch(tracedColor, coord, 0);
+        if (samples[i].a >= 0.0 && samples[i].a < tScene) nearest = min(nearest, samples[i].a);
+    }
+
+    vec3 color = vec3(0.0);
+    float coverage = 0.0;
+    float weightSum = 0.0;
+    for (int i = 0; i < 4; i++) {
+        vec2 w2 = mix(1.0 - f, f, vec2(i & 1, i >> 1));
+        float bilinear = w2.x * w2.y;
+        weightSum += bilinear;
+
+        //        
+        float t = samples[i].a;
+        if (t < 0.0 || t >= tScene) continue;
+
+        float depthWeight = 1.0 / (1.0 + 50.0 * abs(t - nearest) / nearest);
+        color += samples[i].rgb * bilinear * depthWeight;
+        coverage += bilinear * depthWeight;
+    }
+
+    vec3 originalColor = texture(sceneColor, TexCoords).rgb;
+    if (coverage <= 0.0) {
+        FragColor = vec4(originalColor, 1.0);
+        return;
+    }
+    FragColor = vec4(mix(originalColor, color / coverage, clamp(coverage / weightSum, 0.0, 1.0)), 1.0);
+}
@@ -7,8 +7,7 @@ uniform sampler2D sceneColor;
 uniform sampler2D sceneDepth;
 
 uniform vec3 camPos;
-uniform mat3 camRot;
-uniform mat4 projInverse;
+uniform mat4 invViewProjection; //        
 
 struct Light {
     vec3 position;
@@ -20,9 +19,57 @@ uniform int numLights;
 uniform float reflectivity;
 uniform float shadowIntensity;
 
+// 4D-:    ,  4D-     
+uniform int shapeType;          // 0  , 1  , 2  , 3  
+uniform mat4 inverseTransform4D;
+uniform vec4 offset4D;
+uniform float wSlice;
+uniform vec3 objectPosition;
+uniform vec3 objectSize;
+uniform vec3 objectColor;
+uniform float boundingRadius;   //       
+
+//  
+uniform int maxSteps;
+uniform int maxShadowSteps;
+uniform int maxBounces;
+
+//    :   ,      
+uniform float pixelFootprint;
+// false     :  alpha    ,   raymarchUpsample
+uniform bool compositeScene;
+
+float sdTesseract(vec4 p, vec4 b) {
+    vec4 q = abs(p) - b;
+    return length(max(q, 0.0)) + min(max(max(q.x, q.y), max(q.z, q.w)), 0.0);
+}
+
+float sdGlome(vec4 p, float r) {
+    return length(p) - r;
+}
+
+float sdDuocylinder(vec4 p, vec2 r) {
+    vec2 d = vec2(length(p.xy), length(p.zw)) - r;
+    return min(max(d.x, d.y), 0.0) + length(max(d, 0.0));
+}
+
+float sdSpherinder(vec4 p, float r, float h) {
+    vec2 d = vec2(length(p.xyz) - r, abs(p.w) - h);
+    return min(max(d.x, d.y), 0.0) + length(max(d, 0.0));
+}
+
+//   4D     ,     
 float sceneSDF(vec3 p) {
-    float sphere = length(p - vec3(0, 0, -3)) - 1.0;
-    return sphere;
+    vec3 local = (p - objectPosition) / objectSize;
+    vec4 q = inverseTransform4D * (vec4(local, wSlice) - offset4D);
+
+    float d;
+    if (shapeType == 0) d = sdTesseract(q, vec4(0.5));
+    else if (shapeType == 1) d = sdGlome(q, 0.5);
+    else if (shapeType == 2) d = sdDuocylinder(q, vec2(0.5));
+    else d = sdSpherinder(q, 0.5, 0.5);
+
+    return d * min(objectSize.x, min(objectSize.y, objectSize.z));
 }
 
 vec3 calcNormal(vec3 p) {
@@ -34,44 +81,66 @@ vec3 calcNormal(vec3 p) {
                      k.xxx * sceneSDF(p + k.xxx * h));
 }
 
-vec3 traceRayIterative(vec3 ro, vec3 rd) {
+//     :  [tNear, tFar],     
+bool boundingSphere(vec3 ro, vec3 rd, out float tNear, out float tFar) {
+    vec3 oc = ro - objectPosition;
+    float b = dot(oc, rd);
+    float c = dot(oc, oc) - boundingRadius * boundingRadius;
+    float h = b * b - c;
+    if (h < 0.0) return false;
+    h = sqrt(h);
+    tNear = max(-b - h, 0.0);
+    tFar = -b + h;
+    return tFar > 0.0;
+}
+
+bool march(vec3 ro, vec3 rd, float tMax, out float tHit) {
+    float tNear, tFar;
+    if (!boundingSphere(ro, rd, tNear, tFar)) return false;
+
+    float t = tNear;
+    tFar = min(tFar, tMax);
+    for (int i = 0; i < maxSteps && t < tFar; i++) {
+        float d = sceneSDF(ro + rd * t);
+        if (d < max(0.001, t * pixelFootprint)) {
+            tHit = t;
+            return true;
+        }
+        t += d;
+    }
+    return false;
+}
+
+vec3 traceRayIterative(vec3 ro, vec3 rd, float tMax, out float firstHit) {
     vec3 finalColor = vec3(0);
     float reflectAmount = 1.0;
+    float travelled = 0.0; //   :       
+    firstHit = -1.0;
 
-    for (int bounce = 0; bounce < 2; bounce++) {
-        float t = 0.0;
-        bool hit = false;
-        vec3 p;
-        vec3 normal;
-
-        for (int i = 0; i < 64; i++) {
-            p = ro + rd * t;
-            float d = sceneSDF(p);
-            if (d < 0.001) {
-                hit = true;
-                normal = calcNormal(p);
-                break;
-            }
-            t += d;
-            if (t > 20.0) break;
-        }
+    for (int bounce = 0; bounce < maxBounces; bounce++) {
+        float t;
+        if (!march(ro, rd, bounce == 0 ? tMax : 20.0, t)) break;
+        if (bounce == 0) firstHit = t;
+        travelled += t;
+        float footprint = max(0.001, travelled * pixelFootprint);
 
-        if (!hit) break;
+        vec3 p = ro + rd * t;
+        vec3 normal = calcNormal(p);
 
         // 
-        vec3 baseColor = vec3(0.5); //  
-        vec3 lightSum = vec3(0);
+        vec3 lightSum = vec3(0.1);
 
         for (int j = 0; j < numLights; j++) {
             vec3 lightDir = normalize(lights[j].position - p);
             float diff = max(dot(normal, lightDir), 0.0);
 
-            // 
+            // :       ,        
             float shadow = 1.0;
-            float tShadow = 0.01;
-            for (int k = 0; k < 10; k++) {
-                float dShadow = sceneSDF(p + lightDir * tShadow);
-                if (dShadow < 0.001) {
+            vec3 shadowOrigin = p + normal * (2.0 * footprint);
+            float tShadow = 2.0 * footprint;
+            for (int k = 0; k < maxShadowSteps; k++) {
+                float dShadow = sceneSDF(shadowOrigin + lightDir * tShadow);
+                if (dShadow < footprint) {
                     shadow = shadowIntensity;
                     break;
                 }
@@ -82,30 +151,42 @@ vec3 traceRayIterative(vec3 ro, vec3 rd) {
             lightSum += diff * lights[j].color * shadow;
         }
 
-        vec3 localColor = baseColor * lightSum;
-        finalColor += localColor * reflectAmount;
+        vec3 localColor = objectColor * lightSum;
+        finalColor += localColor * reflectAmount * (bounce == 0 ? 1.0 : reflectivity);
 
         //    
         ro = p + normal * 0.01;
         rd = reflect(rd, normal);
         reflectAmount *= reflectivity;
 
-        if (reflectAmount < 0.01) break;
+        // ,       ,    
+        if (reflectAmount < 0.01 || footprint > 0.05) break;
     }
 
     return finalColor;
 }
 
 void main() {
+    //     
+    vec4 farPoint = invViewProjection * vec4(TexCoords * 2.0 - 1.0, 1.0, 1.0);
+    vec3 rayDir = normalize(farPoint.xyz / farPoint.w - camPos);
 
+    //     :   SDF- 
     float depth = texture(sceneDepth, TexCoords).r;
-    vec4 ndc = vec4(TexCoords * 2.0 - 1.0, depth, 1.0);
-    vec4 worldPos = projInverse * ndc;
-    worldPos /= worldPos.w;
+    float tScene = 1e9;
+    if (depth < 1.0) {
+        vec4 scenePoint = invViewProjection * vec4(TexCoords * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+        tScene = length(scenePoint.xyz / scenePoint.w - camPos);
+    }
 
-    vec3 rayDir = normalize(worldPos.xyz - camPos);
-    vec3 tracedColor = traceRayIterative(camPos, rayDir);
     vec3 originalColor = texture(sceneColor, TexCoords).rgb;
 
-    FragColor = vec4(mix(originalColor, tracedColor, 0.5), 1.0);
-}
\ No newline at end of file
+    float tHit;
+    vec3 tracedColor = traceRayIterative(camPos, rayDir, tScene, tHit);
+
+    if (!compositeScene) {
+        FragColor = vec4(tracedColor, tHit);
+        return;
+    }
+    FragColor = vec4(tHit >= 0.0 ? tracedColor : originalColor, 1.0);
+}
@@ -0,0 +1,13 @@
+#version 440 core
+
+layout(location = 0) in vec4 aPos4D; //    
+
+out vec4 Pos4D;
+
+uniform mat4 transform4D;
+uniform vec4 offset4D;
+
+void main() {
+    // 4D-   GPU,    
+    Pos4D = transform4D * aPos4D + offset4D;
+}